@@ -0,0 +1,139 @@
+/*
+ * bitops.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "bitops.h"
+
+#if BITOPS == 1
+
+/**
+ * bmp_ffs
+ */
+int bmp_ffs(const uint32_t *bmp, int nbits)
+{
+	return (bmp_fns(bmp, nbits, 0));
+}
+
+/**
+ * bmp_fns
+ */
+int bmp_fns(const uint32_t *bmp, int nbits, int from)
+{
+	int i = from / 32, n = BMP_WORDS(nbits), r;
+	uint32_t w;
+
+	if (from >= nbits) {
+		return (-1);
+	}
+	w = *(bmp + i) & (~(uint32_t) 0 << from % 32);
+	while (!w) {
+		if (++i == n) {
+			return (-1);
+		}
+		w = *(bmp + i);
+	}
+	r = 32 * i + bit_ctz(w);
+	return (r < nbits ? r : -1);
+}
+
+/**
+ * bmp_ffz
+ */
+int bmp_ffz(const uint32_t *bmp, int nbits)
+{
+	int n = BMP_WORDS(nbits), r;
+
+	for (int i = 0; i < n; i++) {
+		if (~*(bmp + i)) {
+			r = 32 * i + bit_ctz(~*(bmp + i));
+			return (r < nbits ? r : -1);
+		}
+	}
+	return (-1);
+}
+
+/**
+ * bmp_popcnt
+ */
+int bmp_popcnt(const uint32_t *bmp, int nbits)
+{
+	int n = BMP_WORDS(nbits), c = 0;
+
+	for (int i = 0; i < n; i++) {
+		c += bit_popcnt(*(bmp + i));
+	}
+	return (c);
+}
+
+/**
+ * bmp_alloc
+ */
+int bmp_alloc(uint32_t *bmp, int nbits)
+{
+	int n = BMP_WORDS(nbits), b;
+
+	for (int i = 0; i < n; i++) {
+#if BITOPS_CAS == 1
+		uint32_t w = __atomic_load_n(bmp + i, __ATOMIC_RELAXED);
+
+		while (~w) {
+			b = bit_ctz(~w);
+			if (32 * i + b >= nbits) {
+				return (-1);
+			}
+			if (__atomic_compare_exchange_n(bmp + i, &w, w | (uint32_t) 1 << b, TRUE,
+			                                __ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+				return (32 * i + b);
+			}
+		}
+#else
+		taskENTER_CRITICAL();
+		if (~*(bmp + i)) {
+			b = bit_ctz(~*(bmp + i));
+			if (32 * i + b >= nbits) {
+				b = -1;
+			} else {
+				*(bmp + i) |= (uint32_t) 1 << b;
+				b += 32 * i;
+			}
+			taskEXIT_CRITICAL();
+			return (b);
+		}
+		taskEXIT_CRITICAL();
+#endif
+	}
+	return (-1);
+}
+
+/**
+ * bmp_free
+ */
+void bmp_free(uint32_t *bmp, int i)
+{
+#if BITOPS_CAS == 1
+	__atomic_fetch_and(bmp + i / 32, ~((uint32_t) 1 << i % 32), __ATOMIC_RELEASE);
+#else
+	taskENTER_CRITICAL();
+	*(bmp + i / 32) &= ~((uint32_t) 1 << i % 32);
+	taskEXIT_CRITICAL();
+#endif
+}
+#endif
@@ -0,0 +1,213 @@
+/*
+ * bitops.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BITOPS_H
+#define BITOPS_H
+
+#ifndef BITOPS
+ #define BITOPS 0
+#endif
+
+// Use compiler builtins (CLZ/RBIT instructions on ARMv7-M).
+#ifndef BITOPS_BUILTIN
+ #if defined(__GNUC__)
+  #define BITOPS_BUILTIN 1
+ #else
+  #define BITOPS_BUILTIN 0
+ #endif
+#endif
+
+/**
+ * bit_ctz
+ *
+ * Returns: Number of trailing zero bits, 32 if v is 0.
+ */
+static inline int bit_ctz(uint32_t v)
+{
+#if BITOPS_BUILTIN == 1
+	return (v ? __builtin_ctz(v) : 32);
+#else
+	static const uint8_t db[32] = {
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+	};
+
+	return (v ? db[((v & -v) * 0x077CB531U) >> 27] : 32);
+#endif
+}
+
+/**
+ * bit_clz
+ *
+ * Returns: Number of leading zero bits, 32 if v is 0.
+ */
+static inline int bit_clz(uint32_t v)
+{
+#if BITOPS_BUILTIN == 1
+	return (v ? __builtin_clz(v) : 32);
+#else
+	int n = 0;
+
+	if (!v) {
+		return (32);
+	}
+	if (!(v & 0xFFFF0000)) {
+		n += 16;
+		v <<= 16;
+	}
+	if (!(v & 0xFF000000)) {
+		n += 8;
+		v <<= 8;
+	}
+	if (!(v & 0xF0000000)) {
+		n += 4;
+		v <<= 4;
+	}
+	if (!(v & 0xC0000000)) {
+		n += 2;
+		v <<= 2;
+	}
+	if (!(v & 0x80000000)) {
+		n++;
+	}
+	return (n);
+#endif
+}
+
+/**
+ * bit_popcnt
+ *
+ * Returns: Number of set bits.
+ */
+static inline int bit_popcnt(uint32_t v)
+{
+#if BITOPS_BUILTIN == 1
+	return (__builtin_popcount(v));
+#else
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+	v = (v + (v >> 4)) & 0x0F0F0F0F;
+	return ((v * 0x01010101) >> 24);
+#endif
+}
+
+/*
+ * Bitmap is array of uint32_t, bit i is bit (i % 32) of word i / 32.
+ * Bits after nbits in last word must be kept zero.
+ */
+
+// Number of uint32_t words for bitmap of n bits.
+#define BMP_WORDS(n) (((n) + 31) / 32)
+
+/**
+ * bmp_tst
+ *
+ * Returns: TRUE if bit i is set.
+ */
+static inline boolean_t bmp_tst(const uint32_t *bmp, int i)
+{
+	return ((bmp[i >> 5] >> (i & 31)) & 1);
+}
+
+/**
+ * bmp_set
+ *
+ * Set bit i (not atomic).
+ */
+static inline void bmp_set(uint32_t *bmp, int i)
+{
+	bmp[i >> 5] |= 1U << (i & 31);
+}
+
+/**
+ * bmp_clr
+ *
+ * Clear bit i (not atomic, see bmp_free()).
+ */
+static inline void bmp_clr(uint32_t *bmp, int i)
+{
+	bmp[i >> 5] &= ~(1U << (i & 31));
+}
+
+#if BITOPS == 1
+
+// Lock free bmp_alloc() (LDREX/STREX on ARMv7-M, not on ARMv6-M).
+#ifndef BITOPS_CAS
+ #if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_4)
+  #define BITOPS_CAS 1
+ #else
+  #define BITOPS_CAS 0
+ #endif
+#endif
+
+/**
+ * bmp_ffs
+ *
+ * Returns: Index of first set bit or -1.
+ */
+int bmp_ffs(const uint32_t *bmp, int nbits);
+
+/**
+ * bmp_fns
+ *
+ * Returns: Index of first set bit >= from or -1.
+ */
+int bmp_fns(const uint32_t *bmp, int nbits, int from);
+
+/**
+ * bmp_ffz
+ *
+ * Returns: Index of first zero bit or -1.
+ */
+int bmp_ffz(const uint32_t *bmp, int nbits);
+
+/**
+ * bmp_popcnt
+ *
+ * Returns: Number of set bits.
+ */
+int bmp_popcnt(const uint32_t *bmp, int nbits);
+
+/**
+ * BMP_FOR_EACH
+ *
+ * Iterate i over set bits of bitmap (ascending order).
+ */
+#define BMP_FOR_EACH(i, bmp, nbits)\
+	for ((i) = bmp_ffs((bmp), (nbits)); (i) >= 0; (i) = bmp_fns((bmp), (nbits), (i) + 1))
+
+/**
+ * bmp_alloc
+ *
+ * Find lowest zero bit and set it. Operation is atomic: lock free
+ * (compare and swap) where target supports it, otherwise in critical
+ * section (not usable from ISR then, see BITOPS_CAS).
+ *
+ * Returns: Index of allocated bit or -1 (bitmap full).
+ */
+int bmp_alloc(uint32_t *bmp, int nbits);
+
+/**
+ * bmp_free
+ *
+ * Clear bit (atomic, same conditions as bmp_alloc()).
+ */
+void bmp_free(uint32_t *bmp, int i);
+#endif
+
+#endif
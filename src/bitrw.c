@@ -0,0 +1,194 @@
+/*
+ * bitrw.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "bitrw.h"
+#include <string.h>
+
+#if BITRW == 1
+
+static inline uint64_t ld64(const uint8_t *p, enum bitrw_order ord);
+static inline void st64(uint8_t *p, uint64_t v, enum bitrw_order ord);
+
+/**
+ * init_bitreader
+ */
+void init_bitreader(struct bitreader *br, const void *buf, int size, enum bitrw_order ord)
+{
+	br->buf = 0;
+	br->cnt = 0;
+	br->pad = 0;
+	br->start = br->p = buf;
+	br->end = br->p + size;
+	br->ord = ord;
+}
+
+/**
+ * br_fill
+ */
+void br_fill(struct bitreader *br)
+{
+	if (br->end - br->p >= 8) {
+		// Load 8 bytes, keep only whole bytes fitting to buffer.
+		uint64_t v = ld64(br->p, br->ord);
+
+		if (br->ord == BITRW_LSB) {
+			br->buf |= v << br->cnt;
+		} else {
+			br->buf |= v >> br->cnt;
+		}
+		br->p += (63 - br->cnt) >> 3;
+		br->cnt |= 56;
+		return;
+	}
+	while (br->cnt <= 56) {
+		uint64_t v;
+
+		if (br->p < br->end) {
+			v = *br->p++;
+		} else {
+			v = 0;
+			br->pad += 8;
+		}
+		if (br->ord == BITRW_LSB) {
+			br->buf |= v << br->cnt;
+		} else {
+			br->buf |= v << (56 - br->cnt);
+		}
+		br->cnt += 8;
+	}
+}
+
+/**
+ * br_pos
+ */
+int br_pos(const struct bitreader *br)
+{
+	return (8 * (br->p - br->start) + br->pad - br->cnt);
+}
+
+/**
+ * br_ovf
+ */
+boolean_t br_ovf(const struct bitreader *br)
+{
+	return (br_pos(br) > 8 * (br->end - br->start) ? TRUE : FALSE);
+}
+
+/**
+ * init_bitwriter
+ */
+void init_bitwriter(struct bitwriter *bw, void *buf, int size, enum bitrw_order ord)
+{
+	bw->buf = 0;
+	bw->cnt = 0;
+	bw->ovf = FALSE;
+	bw->start = bw->p = buf;
+	bw->end = bw->p + size;
+	bw->ord = ord;
+}
+
+/**
+ * bw_flush
+ */
+void bw_flush(struct bitwriter *bw)
+{
+	int n = bw->cnt >> 3;
+
+	if (!n) {
+		return;
+	}
+	if (bw->end - bw->p >= 8) {
+		// Store 8 bytes, bytes after n are rewritten later.
+		st64(bw->p, bw->buf, bw->ord);
+		bw->p += n;
+	} else {
+		for (int i = 0; i < n; i++) {
+			if (bw->p == bw->end) {
+				bw->ovf = TRUE;
+				break;
+			}
+			if (bw->ord == BITRW_LSB) {
+				*bw->p++ = bw->buf >> 8 * i;
+			} else {
+				*bw->p++ = bw->buf >> (56 - 8 * i);
+			}
+		}
+	}
+	if (n == 8) {
+		bw->buf = 0;
+	} else if (bw->ord == BITRW_LSB) {
+		bw->buf >>= 8 * n;
+	} else {
+		bw->buf <<= 8 * n;
+	}
+	bw->cnt -= 8 * n;
+}
+
+/**
+ * bw_finish
+ */
+int bw_finish(struct bitwriter *bw)
+{
+	bw_flush(bw);
+	if (bw->cnt) {
+		bw->cnt = 8;
+		bw_flush(bw);
+	}
+	return (bw->ovf ? -1 : bw->p - bw->start);
+}
+
+/**
+ * ld64
+ */
+static inline uint64_t ld64(const uint8_t *p, enum bitrw_order ord)
+{
+	uint64_t v;
+
+	memcpy(&v, p, 8);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if (ord == BITRW_MSB) {
+		v = __builtin_bswap64(v);
+	}
+#else
+	if (ord == BITRW_LSB) {
+		v = __builtin_bswap64(v);
+	}
+#endif
+	return (v);
+}
+
+/**
+ * st64
+ */
+static inline void st64(uint8_t *p, uint64_t v, enum bitrw_order ord)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if (ord == BITRW_MSB) {
+		v = __builtin_bswap64(v);
+	}
+#else
+	if (ord == BITRW_LSB) {
+		v = __builtin_bswap64(v);
+	}
+#endif
+	memcpy(p, &v, 8);
+}
+#endif
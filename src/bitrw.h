@@ -0,0 +1,191 @@
+/*
+ * bitrw.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef BITRW_H
+#define BITRW_H
+
+#ifndef BITRW
+ #define BITRW 0
+#endif
+
+#if BITRW == 1
+
+// Maximum number of bits for one peek/read/write.
+#define BITRW_MAX_BITS 56
+
+/*
+ * Bit order. LSB first: bit 0 of byte 0 is first bit of stream, value bits
+ * are stored from LSB (same as extract_bits_le()). MSB first: bit 7 of
+ * byte 0 is first bit, value bits are stored from MSB (network order).
+ */
+enum bitrw_order {
+	BITRW_LSB,
+	BITRW_MSB
+};
+
+struct bitreader {
+	uint64_t buf; // Bit buffer (LSB: next bit in bit 0, MSB: in bit 63).
+	int cnt; // Number of valid bits in buf.
+	int pad; // Zero bits appended after end of input.
+	const uint8_t *p;
+	const uint8_t *end;
+	const uint8_t *start;
+	enum bitrw_order ord;
+};
+
+struct bitwriter {
+	uint64_t buf; // Pending bits (LSB: from bit 0, MSB: from bit 63).
+	int cnt; // Number of pending bits.
+	boolean_t ovf;
+	uint8_t *p;
+	uint8_t *end;
+	uint8_t *start;
+	enum bitrw_order ord;
+};
+
+/**
+ * init_bitreader
+ *
+ * @br: Pointer to reader.
+ * @buf: Pointer to input bytes.
+ * @size: Input size in bytes.
+ * @ord: Bit order.
+ */
+void init_bitreader(struct bitreader *br, const void *buf, int size, enum bitrw_order ord);
+
+/**
+ * br_fill
+ *
+ * Refill bit buffer to at least BITRW_MAX_BITS + 1 bits (word load when
+ * 8 input bytes are available). Zero bits are supplied after end of input
+ * (see br_ovf()).
+ */
+void br_fill(struct bitreader *br);
+
+/**
+ * br_peek
+ *
+ * Returns: Next n (1 - BITRW_MAX_BITS) bits without consuming them.
+ */
+static inline uint64_t br_peek(struct bitreader *br, int n)
+{
+	if (br->cnt < n) {
+		br_fill(br);
+	}
+	if (br->ord == BITRW_LSB) {
+		return (br->buf & (((uint64_t) 1 << n) - 1));
+	} else {
+		return (br->buf >> (64 - n));
+	}
+}
+
+/**
+ * br_skip
+ *
+ * Consume n (0 - BITRW_MAX_BITS) bits. Bits must be peeked before (or n
+ * must not exceed number of buffered bits), use br_read() otherwise.
+ */
+static inline void br_skip(struct bitreader *br, int n)
+{
+	if (br->ord == BITRW_LSB) {
+		br->buf >>= n;
+	} else {
+		br->buf <<= n;
+	}
+	br->cnt -= n;
+}
+
+/**
+ * br_read
+ *
+ * Returns: Next n (1 - BITRW_MAX_BITS) bits.
+ */
+static inline uint64_t br_read(struct bitreader *br, int n)
+{
+	uint64_t v = br_peek(br, n);
+
+	br_skip(br, n);
+	return (v);
+}
+
+/**
+ * br_pos
+ *
+ * Returns: Number of consumed bits.
+ */
+int br_pos(const struct bitreader *br);
+
+/**
+ * br_ovf
+ *
+ * Returns: TRUE if bits after end of input were consumed.
+ */
+boolean_t br_ovf(const struct bitreader *br);
+
+/**
+ * init_bitwriter
+ *
+ * Output is stored by 8 byte words, so bytes of buffer after written
+ * length may be modified.
+ *
+ * @bw: Pointer to writer.
+ * @buf: Pointer to output buffer.
+ * @size: Output buffer size in bytes.
+ * @ord: Bit order.
+ */
+void init_bitwriter(struct bitwriter *bw, void *buf, int size, enum bitrw_order ord);
+
+/**
+ * bw_flush
+ *
+ * Store complete bytes from bit buffer to output (word store when 8 bytes
+ * of output space are available). Bits not fitting to output set overflow
+ * flag and are dropped.
+ */
+void bw_flush(struct bitwriter *bw);
+
+/**
+ * bw_write
+ *
+ * Append n (1 - BITRW_MAX_BITS) low bits of v.
+ */
+static inline void bw_write(struct bitwriter *bw, int n, uint64_t v)
+{
+	if (bw->cnt + n > 64) {
+		bw_flush(bw);
+	}
+	v &= ((uint64_t) 1 << n) - 1;
+	if (bw->ord == BITRW_LSB) {
+		bw->buf |= v << bw->cnt;
+	} else {
+		bw->buf |= v << (64 - bw->cnt - n);
+	}
+	bw->cnt += n;
+}
+
+/**
+ * bw_finish
+ *
+ * Store pending bits, last byte is padded with zero bits.
+ *
+ * Returns: Number of output bytes or -1 (output buffer overflow).
+ */
+int bw_finish(struct bitwriter *bw);
+#endif
+
+#endif
@@ -22,102 +22,632 @@
 #include <queue.h>
 #include <gentyp.h>
 #include "sysconf.h"
+#include "criterr.h"
 #include "crc.h"
 
+#include "crctbl.h"
+#if CRC_PARALLEL == 1
+#include <pthread.h>
+#endif
+
+#if CRC_8_SLICE > 1 || CRC_16_SLICE > 1 || CRC_CCIT_SLICE > 1 || CRC_32_SLICE > 1 || \
+    CRC_32C_SLICE > 1
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+ #error "crc.c slicing requires little endian target"
+#endif
+#endif
+
+#if CRC_8_FUNC == 1
+#if CRC_8_SLICE == CRC_SLICE_NIB
+ #define CRC8_07_TBL crc8_nib_07
+#elif CRC_8_SLICE >= 1
+ #define CRC8_07_TBL crc8_tbl_07
+#else
+ #define CRC8_07_TBL NULL
+#endif
+#endif
+
+#if CRC_16_FUNC == 1
+#if CRC_16_SLICE == CRC_SLICE_NIB
+ #define CRC16_8005_TBL crc16_nib_8005
+#elif CRC_16_SLICE >= 1
+ #define CRC16_8005_TBL crc16_tbl_8005
+#else
+ #define CRC16_8005_TBL NULL
+#endif
+#endif
+
+#if CRC_CCIT_FUNC == 1
+#if CRC_CCIT_SLICE == CRC_SLICE_NIB
+ #define CRC16_1021_TBL crc16_nib_1021
+#elif CRC_CCIT_SLICE >= 1
+ #define CRC16_1021_TBL crc16_tbl_1021
+#else
+ #define CRC16_1021_TBL NULL
+#endif
+#endif
+
+#if CRC_32_FUNC == 1
+#if CRC_32_SLICE == CRC_SLICE_NIB
+ #define CRC32_04C11DB7_TBL crc32_nib_04C11DB7
+#elif CRC_32_SLICE >= 1
+ #define CRC32_04C11DB7_TBL crc32_tbl_04C11DB7
+#else
+ #define CRC32_04C11DB7_TBL NULL
+#endif
+#endif
+
+#if CRC_32C_FUNC == 1
+#if CRC_32C_SLICE == CRC_SLICE_NIB
+ #define CRC32_1EDC6F41_TBL crc32_nib_1EDC6F41
+#elif CRC_32C_SLICE >= 1
+ #define CRC32_1EDC6F41_TBL crc32_tbl_1EDC6F41
+#else
+ #define CRC32_1EDC6F41_TBL NULL
+#endif
+#endif
+
+#if CRC_8_FUNC == 1
+const struct crc_model crc8_smbus = {
+	"CRC-8/SMBUS", 8, FALSE, 0x07, 0x00, 0x00, 0xF4, CRC8_07_TBL, CRC_8_SLICE
+};
+#endif
+
 #if CRC_16_FUNC == 1
-// CRC table for CRC-16. Poly is 0x8005 (x^16 + x^15 + x^2 + 1).
-static const uint16_t crc16_tbl_8005[256] = {
-	0x0000, 0xC0C1, 0xC181, 0x0140, 0xC301, 0x03C0, 0x0280, 0xC241,
-	0xC601, 0x06C0, 0x0780, 0xC741, 0x0500, 0xC5C1, 0xC481, 0x0440,
-	0xCC01, 0x0CC0, 0x0D80, 0xCD41, 0x0F00, 0xCFC1, 0xCE81, 0x0E40,
-	0x0A00, 0xCAC1, 0xCB81, 0x0B40, 0xC901, 0x09C0, 0x0880, 0xC841,
-	0xD801, 0x18C0, 0x1980, 0xD941, 0x1B00, 0xDBC1, 0xDA81, 0x1A40,
-	0x1E00, 0xDEC1, 0xDF81, 0x1F40, 0xDD01, 0x1DC0, 0x1C80, 0xDC41,
-	0x1400, 0xD4C1, 0xD581, 0x1540, 0xD701, 0x17C0, 0x1680, 0xD641,
-	0xD201, 0x12C0, 0x1380, 0xD341, 0x1100, 0xD1C1, 0xD081, 0x1040,
-	0xF001, 0x30C0, 0x3180, 0xF141, 0x3300, 0xF3C1, 0xF281, 0x3240,
-	0x3600, 0xF6C1, 0xF781, 0x3740, 0xF501, 0x35C0, 0x3480, 0xF441,
-	0x3C00, 0xFCC1, 0xFD81, 0x3D40, 0xFF01, 0x3FC0, 0x3E80, 0xFE41,
-	0xFA01, 0x3AC0, 0x3B80, 0xFB41, 0x3900, 0xF9C1, 0xF881, 0x3840,
-	0x2800, 0xE8C1, 0xE981, 0x2940, 0xEB01, 0x2BC0, 0x2A80, 0xEA41,
-	0xEE01, 0x2EC0, 0x2F80, 0xEF41, 0x2D00, 0xEDC1, 0xEC81, 0x2C40,
-	0xE401, 0x24C0, 0x2580, 0xE541, 0x2700, 0xE7C1, 0xE681, 0x2640,
-	0x2200, 0xE2C1, 0xE381, 0x2340, 0xE101, 0x21C0, 0x2080, 0xE041,
-	0xA001, 0x60C0, 0x6180, 0xA141, 0x6300, 0xA3C1, 0xA281, 0x6240,
-	0x6600, 0xA6C1, 0xA781, 0x6740, 0xA501, 0x65C0, 0x6480, 0xA441,
-	0x6C00, 0xACC1, 0xAD81, 0x6D40, 0xAF01, 0x6FC0, 0x6E80, 0xAE41,
-	0xAA01, 0x6AC0, 0x6B80, 0xAB41, 0x6900, 0xA9C1, 0xA881, 0x6840,
-	0x7800, 0xB8C1, 0xB981, 0x7940, 0xBB01, 0x7BC0, 0x7A80, 0xBA41,
-	0xBE01, 0x7EC0, 0x7F80, 0xBF41, 0x7D00, 0xBDC1, 0xBC81, 0x7C40,
-	0xB401, 0x74C0, 0x7580, 0xB541, 0x7700, 0xB7C1, 0xB681, 0x7640,
-	0x7200, 0xB2C1, 0xB381, 0x7340, 0xB101, 0x71C0, 0x7080, 0xB041,
-	0x5000, 0x90C1, 0x9181, 0x5140, 0x9301, 0x53C0, 0x5280, 0x9241,
-	0x9601, 0x56C0, 0x5780, 0x9741, 0x5500, 0x95C1, 0x9481, 0x5440,
-	0x9C01, 0x5CC0, 0x5D80, 0x9D41, 0x5F00, 0x9FC1, 0x9E81, 0x5E40,
-	0x5A00, 0x9AC1, 0x9B81, 0x5B40, 0x9901, 0x59C0, 0x5880, 0x9841,
-	0x8801, 0x48C0, 0x4980, 0x8941, 0x4B00, 0x8BC1, 0x8A81, 0x4A40,
-	0x4E00, 0x8EC1, 0x8F81, 0x4F40, 0x8D01, 0x4DC0, 0x4C80, 0x8C41,
-	0x4400, 0x84C1, 0x8581, 0x4540, 0x8701, 0x47C0, 0x4680, 0x8641,
-	0x8201, 0x42C0, 0x4380, 0x8341, 0x4100, 0x81C1, 0x8081, 0x4040
+const struct crc_model crc16_arc = {
+	"CRC-16/ARC", 16, TRUE, 0x8005, 0x0000, 0x0000, 0xBB3D, CRC16_8005_TBL, CRC_16_SLICE
+};
+
+const struct crc_model crc16_modbus = {
+	"CRC-16/MODBUS", 16, TRUE, 0x8005, 0xFFFF, 0x0000, 0x4B37, CRC16_8005_TBL, CRC_16_SLICE
+};
+#endif
+
+#if CRC_CCIT_FUNC == 1
+const struct crc_model crc16_ibm3740 = {
+	"CRC-16/IBM-3740", 16, FALSE, 0x1021, 0xFFFF, 0x0000, 0x29B1, CRC16_1021_TBL, CRC_CCIT_SLICE
+};
+
+const struct crc_model crc16_xmodem = {
+	"CRC-16/XMODEM", 16, FALSE, 0x1021, 0x0000, 0x0000, 0x31C3, CRC16_1021_TBL, CRC_CCIT_SLICE
+};
+#endif
+
+#if CRC_32_FUNC == 1
+const struct crc_model crc32 = {
+	"CRC-32/ISO-HDLC", 32, TRUE, 0x04C11DB7, 0xFFFFFFFF, 0xFFFFFFFF, 0xCBF43926,
+	CRC32_04C11DB7_TBL, CRC_32_SLICE
+};
+#endif
+
+#if CRC_32C_FUNC == 1
+const struct crc_model crc32c = {
+	"CRC-32/ISCSI", 32, TRUE, 0x1EDC6F41, 0xFFFFFFFF, 0xFFFFFFFF, 0xE3069283,
+	CRC32_1EDC6F41_TBL, CRC_32C_SLICE
+};
+#endif
+
+#define CRC_W8 (CRC_8_FUNC == 1 && CRC_8_SLICE >= 1)
+#define CRC_W16 ((CRC_16_FUNC == 1 && CRC_16_SLICE >= 1) || (CRC_CCIT_FUNC == 1 && CRC_CCIT_SLICE >= 1))
+#define CRC_W32 ((CRC_32_FUNC == 1 && CRC_32_SLICE >= 1) || (CRC_32C_FUNC == 1 && CRC_32C_SLICE >= 1))
+
+static uint32_t upd(const struct crc_model *m, uint32_t crc, const uint8_t *buf, int size);
+static uint32_t upd_bit(const struct crc_model *m, uint32_t crc, const uint8_t *buf, int size);
+static uint32_t upd_nib(const struct crc_model *m, uint32_t crc, const uint8_t *buf, int size);
+
+#if CRC_W8
+static uint32_t upd8(const uint8_t (*t)[256], int slc, uint32_t crc, const uint8_t *buf, int size);
+#endif
+#if CRC_W16
+static uint32_t upd16(const uint16_t (*t)[256], int slc, boolean_t refl, uint32_t crc,
+                      const uint8_t *buf, int size);
+#endif
+#if CRC_W32
+static uint32_t upd32(const uint32_t (*t)[256], int slc, boolean_t refl, uint32_t crc,
+                      const uint8_t *buf, int size);
+#endif
+static uint32_t shift_reg(const struct crc_model *m, uint32_t crc, unsigned long n);
+static uint32_t mulmod(const struct crc_model *m, uint32_t a, uint32_t b);
+static uint32_t refl_w(uint32_t v, int w);
+
+/**
+ * crc_update
+ */
+uint32_t crc_update(const struct crc_model *m, uint32_t crc, const void *buf, int size)
+{
+#if CRC_CLMUL == 1 && CRC_16_FUNC == 1
+	if (m->width == 16 && m->refl && m->poly == 0x8005) {
+		return (crc_16(crc, buf, size));
+	}
+#endif
+#if CRC_CLMUL == 1 && CRC_CCIT_FUNC == 1
+	if (m->width == 16 && !m->refl && m->poly == 0x1021) {
+		return (crc_ccit(crc, buf, size));
+	}
+#endif
+	return (upd(m, crc, buf, size));
+}
+
+/**
+ * upd
+ */
+static uint32_t upd(const struct crc_model *m, uint32_t crc, const uint8_t *buf, int size)
+{
+	if (m->slc == CRC_SLICE_BIT) {
+		return (upd_bit(m, crc, buf, size));
+	} else if (m->slc == CRC_SLICE_NIB) {
+		return (upd_nib(m, crc, buf, size));
+	}
+	switch (m->width) {
+#if CRC_W8
+	case 8 :
+		return (upd8(m->tbl, m->slc, crc, buf, size));
+#endif
+#if CRC_W16
+	case 16 :
+		return (upd16(m->tbl, m->slc, m->refl, crc, buf, size));
+#endif
+#if CRC_W32
+	case 32 :
+		return (upd32(m->tbl, m->slc, m->refl, crc, buf, size));
+#endif
+	default :
+		crit_err_exit(BAD_PARAMETER);
+		return (0);
+	}
+}
+
+/**
+ * upd_bit
+ */
+static uint32_t upd_bit(const struct crc_model *m, uint32_t crc, const uint8_t *buf, int size)
+{
+	uint32_t top = (uint32_t) 1 << (m->width - 1), msk = top | (top - 1), p;
+
+	if (m->refl) {
+		p = refl_w(m->poly, m->width);
+		while (size--) {
+			crc ^= *buf++;
+			for (int i = 0; i < 8; i++) {
+				crc = (crc >> 1) ^ (-(crc & 1) & p);
+			}
+		}
+	} else {
+		while (size--) {
+			crc ^= (uint32_t) *buf++ << (m->width - 8);
+			for (int i = 0; i < 8; i++) {
+				crc = (crc << 1) ^ (-((crc >> (m->width - 1)) & 1) & m->poly);
+			}
+			crc &= msk;
+		}
+	}
+	return (crc);
+}
+
+/**
+ * upd_nib
+ */
+static uint32_t upd_nib(const struct crc_model *m, uint32_t crc, const uint8_t *buf, int size)
+{
+	uint32_t t[16], top = (uint32_t) 1 << (m->width - 1), msk = top | (top - 1);
+
+	for (int i = 0; i < 16; i++) {
+		switch (m->width) {
+		case 8 :
+			t[i] = *((const uint8_t *) m->tbl + i);
+			break;
+		case 16 :
+			t[i] = *((const uint16_t *) m->tbl + i);
+			break;
+		default :
+			t[i] = *((const uint32_t *) m->tbl + i);
+			break;
+		}
+	}
+	if (m->refl) {
+		while (size--) {
+			crc ^= *buf++;
+			crc = (crc >> 4) ^ t[crc & 0x0FU];
+			crc = (crc >> 4) ^ t[crc & 0x0FU];
+		}
+	} else {
+		while (size--) {
+			crc ^= (uint32_t) *buf++ << (m->width - 8);
+			crc = ((crc << 4) & msk) ^ t[(crc >> (m->width - 4)) & 0x0FU];
+			crc = ((crc << 4) & msk) ^ t[(crc >> (m->width - 4)) & 0x0FU];
+		}
+	}
+	return (crc);
+}
+
+/**
+ * crc_tbl_size
+ */
+int crc_tbl_size(const struct crc_model *m)
+{
+	if (m->slc == CRC_SLICE_BIT) {
+		return (0);
+	} else if (m->slc == CRC_SLICE_NIB) {
+		return (16 * m->width / 8);
+	}
+	return (m->slc * 256 * m->width / 8);
+}
+
+/**
+ * crc_calc
+ */
+uint32_t crc_calc(const struct crc_model *m, const void *buf, int size)
+{
+	return (crc_update(m, m->init, buf, size) ^ m->xorout);
+}
+
+/**
+ * crc_update_iov
+ */
+uint32_t crc_update_iov(const struct crc_model *m, uint32_t crc, const struct crc_seg *seg, int cnt)
+{
+	for (int i = 0; i < cnt; i++) {
+		crc = crc_update(m, crc, (seg + i)->p, (seg + i)->len);
+	}
+	return (crc);
+}
+
+/**
+ * crc_update_ring
+ */
+uint32_t crc_update_ring(const struct crc_model *m, uint32_t crc, const void *rb, int rb_sz,
+                         int ofs, int len)
+{
+	int n;
+
+	if (ofs < 0 || ofs >= rb_sz || len < 0 || len > rb_sz) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	n = rb_sz - ofs;
+	if (n >= len) {
+		return (crc_update(m, crc, (const uint8_t *) rb + ofs, len));
+	}
+	crc = crc_update(m, crc, (const uint8_t *) rb + ofs, n);
+	return (crc_update(m, crc, rb, len - n));
+}
+
+/**
+ * crc_combine
+ */
+uint32_t crc_combine(const struct crc_model *m, uint32_t crc_a, uint32_t crc_b,
+                     unsigned long len_b)
+{
+	return (shift_reg(m, crc_a ^ m->xorout ^ m->init, len_b) ^ crc_b);
+}
+
+/**
+ * shift_reg
+ *
+ * Register after n zero bytes: crc * x^(8n) mod P. Power is computed by
+ * repeated squaring of x^8 mod P.
+ */
+static uint32_t shift_reg(const struct crc_model *m, uint32_t crc, unsigned long n)
+{
+	uint32_t p = 1, sq = 1;
+
+	for (int i = 0; i < 8; i++) {
+		sq = mulmod(m, sq, 2);
+	}
+	while (n) {
+		if (n & 1) {
+			p = mulmod(m, p, sq);
+		}
+		sq = mulmod(m, sq, sq);
+		n >>= 1;
+	}
+	if (m->refl) {
+		return (refl_w(mulmod(m, refl_w(crc, m->width), p), m->width));
+	}
+	return (mulmod(m, crc, p));
+}
+
+/**
+ * mulmod
+ *
+ * a * b mod P (normal bit order).
+ */
+static uint32_t mulmod(const struct crc_model *m, uint32_t a, uint32_t b)
+{
+	uint32_t r = 0, top = (uint32_t) 1 << (m->width - 1);
+	uint32_t msk = top | (top - 1);
+
+	for (uint32_t bit = top; bit; bit >>= 1) {
+		if (r & top) {
+			r = ((r << 1) ^ m->poly) & msk;
+		} else {
+			r <<= 1;
+		}
+		if (a & bit) {
+			r ^= b;
+		}
+	}
+	return (r);
+}
+
+/**
+ * refl_w
+ */
+static uint32_t refl_w(uint32_t v, int w)
+{
+	uint32_t r = 0;
+
+	for (int i = 0; i < w; i++) {
+		r = (r << 1) | (v & 1);
+		v >>= 1;
+	}
+	return (r);
+}
+
+#if CRC_PARALLEL == 1
+struct par_chunk {
+	const struct crc_model *m;
+	const uint8_t *p;
+	unsigned long sz;
+	uint32_t crc;
 };
 
+/**
+ * par_thr
+ */
+static void *par_thr(void *arg)
+{
+	struct par_chunk *c = arg;
+	const uint8_t *p = c->p;
+	unsigned long sz = c->sz;
+	int n;
+
+	while (sz) {
+		n = sz > 0x40000000UL ? 0x40000000 : (int) sz;
+		c->crc = crc_update(c->m, c->crc, p, n);
+		p += n;
+		sz -= n;
+	}
+	return (NULL);
+}
+
+/**
+ * crc_par
+ */
+uint32_t crc_par(const struct crc_model *m, const void *buf, unsigned long size, int nthr)
+{
+	struct par_chunk ch[CRC_PARALLEL_MAX_THR];
+	pthread_t thr[CRC_PARALLEL_MAX_THR];
+	boolean_t run[CRC_PARALLEL_MAX_THR];
+	unsigned long csz;
+	uint32_t crc;
+
+	if (nthr < 1 || nthr > CRC_PARALLEL_MAX_THR) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	if (size < (unsigned long) nthr * 65536) {
+		nthr = 1;
+	}
+	csz = size / nthr;
+	for (int i = nthr - 1; i >= 0; i--) {
+		ch[i].m = m;
+		ch[i].p = (const uint8_t *) buf + i * csz;
+		ch[i].sz = (i == nthr - 1) ? size - i * csz : csz;
+		ch[i].crc = (i == 0) ? m->init : 0;
+		run[i] = FALSE;
+		if (i && 0 == pthread_create(&thr[i], NULL, par_thr, &ch[i])) {
+			run[i] = TRUE;
+		} else {
+			par_thr(&ch[i]);
+		}
+	}
+	crc = ch[0].crc;
+	for (int i = 1; i < nthr; i++) {
+		if (run[i]) {
+			pthread_join(thr[i], NULL);
+		}
+		crc = shift_reg(m, crc, ch[i].sz) ^ ch[i].crc;
+	}
+	return (crc ^ m->xorout);
+}
+#endif
+
+/*
+ * SLICE_BLK
+ *
+ * Process slc bytes (aligned words) with slc tables. Table k gives CRC of
+ * byte followed by k zero bytes, so register (mix, arranged in memory byte
+ * order) is XORed into first word and partial results are XORed together.
+ */
+#define SLICE_BLK(t, slc, crc, mix, p)                                        \
+	do {                                                                  \
+		uint32_t w_, c_ = 0;                                          \
+		for (int k_ = (slc) - 1; k_ > 0; k_ -= 4) {                   \
+			w_ = *(p)++;                                          \
+			if (k_ == (slc) - 1) {                                \
+				w_ ^= (mix);                                  \
+			}                                                     \
+			c_ ^= (t)[k_][w_ & 0xFFU] ^ (t)[k_ - 1][(w_ >> 8) & 0xFFU] ^ \
+			      (t)[k_ - 2][(w_ >> 16) & 0xFFU] ^ (t)[k_ - 3][w_ >> 24]; \
+		}                                                             \
+		(crc) = c_;                                                   \
+	} while (0)
+
+#if CRC_W8
+/**
+ * upd8
+ */
+static uint32_t upd8(const uint8_t (*t)[256], int slc, uint32_t crc, const uint8_t *buf, int size)
+{
+	const uint32_t *p;
+
+	if (slc > 1) {
+		while (size && ((uintptr_t) buf & 3)) {
+			crc = t[0][crc ^ *buf++];
+			size--;
+		}
+		p = (const uint32_t *) buf;
+		for (; size >= slc; size -= slc) {
+			switch (slc) {
+			case 4 :
+				SLICE_BLK(t, 4, crc, crc, p);
+				break;
+			case 8 :
+				SLICE_BLK(t, 8, crc, crc, p);
+				break;
+			default :
+				SLICE_BLK(t, 16, crc, crc, p);
+				break;
+			}
+		}
+		buf = (const uint8_t *) p;
+	}
+	while (size--) {
+		crc = t[0][crc ^ *buf++];
+	}
+	return (crc);
+}
+
+#endif
+
+#if CRC_W16
+/**
+ * upd16
+ */
+static uint32_t upd16(const uint16_t (*t)[256], int slc, boolean_t refl, uint32_t crc,
+                      const uint8_t *buf, int size)
+{
+	const uint32_t *p;
+
+	if (slc > 1) {
+		while (size && ((uintptr_t) buf & 3)) {
+			if (refl) {
+				crc = (crc >> 8) ^ t[0][(crc ^ *buf++) & 0xFFU];
+			} else {
+				crc = ((crc << 8) & 0xFFFFU) ^ t[0][(crc >> 8 ^ *buf++) & 0xFFU];
+			}
+			size--;
+		}
+		p = (const uint32_t *) buf;
+		for (; size >= slc; size -= slc) {
+			uint32_t mix = refl ? crc : ((crc >> 8) | (crc << 8)) & 0xFFFFU;
+			switch (slc) {
+			case 4 :
+				SLICE_BLK(t, 4, crc, mix, p);
+				break;
+			case 8 :
+				SLICE_BLK(t, 8, crc, mix, p);
+				break;
+			default :
+				SLICE_BLK(t, 16, crc, mix, p);
+				break;
+			}
+		}
+		buf = (const uint8_t *) p;
+	}
+	if (refl) {
+		while (size--) {
+			crc = (crc >> 8) ^ t[0][(crc ^ *buf++) & 0xFFU];
+		}
+	} else {
+		while (size--) {
+			crc = ((crc << 8) & 0xFFFFU) ^ t[0][(crc >> 8 ^ *buf++) & 0xFFU];
+		}
+	}
+	return (crc);
+}
+
+#endif
+
+#if CRC_W32
+/**
+ * upd32
+ */
+static uint32_t upd32(const uint32_t (*t)[256], int slc, boolean_t refl, uint32_t crc,
+                      const uint8_t *buf, int size)
+{
+	const uint32_t *p;
+
+	if (slc > 1) {
+		while (size && ((uintptr_t) buf & 3)) {
+			if (refl) {
+				crc = (crc >> 8) ^ t[0][(crc ^ *buf++) & 0xFFU];
+			} else {
+				crc = (crc << 8) ^ t[0][(crc >> 24 ^ *buf++) & 0xFFU];
+			}
+			size--;
+		}
+		p = (const uint32_t *) buf;
+		for (; size >= slc; size -= slc) {
+			uint32_t mix = refl ? crc : __builtin_bswap32(crc);
+			switch (slc) {
+			case 4 :
+				SLICE_BLK(t, 4, crc, mix, p);
+				break;
+			case 8 :
+				SLICE_BLK(t, 8, crc, mix, p);
+				break;
+			default :
+				SLICE_BLK(t, 16, crc, mix, p);
+				break;
+			}
+		}
+		buf = (const uint8_t *) p;
+	}
+	if (refl) {
+		while (size--) {
+			crc = (crc >> 8) ^ t[0][(crc ^ *buf++) & 0xFFU];
+		}
+	} else {
+		while (size--) {
+			crc = (crc << 8) ^ t[0][(crc >> 24 ^ *buf++) & 0xFFU];
+		}
+	}
+	return (crc);
+}
+#endif
+
+#if CRC_16_FUNC == 1
 /**
  * crc_16
  */
 uint16_t crc_16(uint16_t crc, const uint8_t *buf, int size)
 {
-        while (size--) {
-                crc = (crc >> 8) ^ crc16_tbl_8005[(crc ^ *buf++) & 0xFFU];
-        }
-        return (crc);
+#if CRC_CLMUL == 1
+	if (size >= 64 && crc_clmul_ok()) {
+		return (crc_16_clmul(crc, buf, size));
+	}
+#endif
+	return (upd(&crc16_arc, crc, buf, size));
+}
+
+/**
+ * crc_16_combine
+ */
+uint16_t crc_16_combine(uint16_t crc_a, uint16_t crc_b, unsigned long len_b)
+{
+	return (crc_combine(&crc16_arc, crc_a, crc_b, len_b));
 }
 #endif
 
 #if CRC_CCIT_FUNC == 1
-// CRC table for CRC_CCITT. Poly is 0x1021 (x^16 + x^12 + x^5 + 1).
-static const uint16_t crc16_tbl_1021[256] = {
-        0x0000, 0x1021, 0x2042, 0x3063, 0x4084, 0x50a5, 0x60c6, 0x70e7,
-        0x8108, 0x9129, 0xa14a, 0xb16b, 0xc18c, 0xd1ad, 0xe1ce, 0xf1ef,
-        0x1231, 0x0210, 0x3273, 0x2252, 0x52b5, 0x4294, 0x72f7, 0x62d6,
-        0x9339, 0x8318, 0xb37b, 0xa35a, 0xd3bd, 0xc39c, 0xf3ff, 0xe3de,
-        0x2462, 0x3443, 0x0420, 0x1401, 0x64e6, 0x74c7, 0x44a4, 0x5485,
-        0xa56a, 0xb54b, 0x8528, 0x9509, 0xe5ee, 0xf5cf, 0xc5ac, 0xd58d,
-        0x3653, 0x2672, 0x1611, 0x0630, 0x76d7, 0x66f6, 0x5695, 0x46b4,
-        0xb75b, 0xa77a, 0x9719, 0x8738, 0xf7df, 0xe7fe, 0xd79d, 0xc7bc,
-        0x48c4, 0x58e5, 0x6886, 0x78a7, 0x0840, 0x1861, 0x2802, 0x3823,
-        0xc9cc, 0xd9ed, 0xe98e, 0xf9af, 0x8948, 0x9969, 0xa90a, 0xb92b,
-        0x5af5, 0x4ad4, 0x7ab7, 0x6a96, 0x1a71, 0x0a50, 0x3a33, 0x2a12,
-        0xdbfd, 0xcbdc, 0xfbbf, 0xeb9e, 0x9b79, 0x8b58, 0xbb3b, 0xab1a,
-        0x6ca6, 0x7c87, 0x4ce4, 0x5cc5, 0x2c22, 0x3c03, 0x0c60, 0x1c41,
-        0xedae, 0xfd8f, 0xcdec, 0xddcd, 0xad2a, 0xbd0b, 0x8d68, 0x9d49,
-        0x7e97, 0x6eb6, 0x5ed5, 0x4ef4, 0x3e13, 0x2e32, 0x1e51, 0x0e70,
-        0xff9f, 0xefbe, 0xdfdd, 0xcffc, 0xbf1b, 0xaf3a, 0x9f59, 0x8f78,
-        0x9188, 0x81a9, 0xb1ca, 0xa1eb, 0xd10c, 0xc12d, 0xf14e, 0xe16f,
-        0x1080, 0x00a1, 0x30c2, 0x20e3, 0x5004, 0x4025, 0x7046, 0x6067,
-        0x83b9, 0x9398, 0xa3fb, 0xb3da, 0xc33d, 0xd31c, 0xe37f, 0xf35e,
-        0x02b1, 0x1290, 0x22f3, 0x32d2, 0x4235, 0x5214, 0x6277, 0x7256,
-        0xb5ea, 0xa5cb, 0x95a8, 0x8589, 0xf56e, 0xe54f, 0xd52c, 0xc50d,
-        0x34e2, 0x24c3, 0x14a0, 0x0481, 0x7466, 0x6447, 0x5424, 0x4405,
-        0xa7db, 0xb7fa, 0x8799, 0x97b8, 0xe75f, 0xf77e, 0xc71d, 0xd73c,
-        0x26d3, 0x36f2, 0x0691, 0x16b0, 0x6657, 0x7676, 0x4615, 0x5634,
-        0xd94c, 0xc96d, 0xf90e, 0xe92f, 0x99c8, 0x89e9, 0xb98a, 0xa9ab,
-        0x5844, 0x4865, 0x7806, 0x6827, 0x18c0, 0x08e1, 0x3882, 0x28a3,
-        0xcb7d, 0xdb5c, 0xeb3f, 0xfb1e, 0x8bf9, 0x9bd8, 0xabbb, 0xbb9a,
-        0x4a75, 0x5a54, 0x6a37, 0x7a16, 0x0af1, 0x1ad0, 0x2ab3, 0x3a92,
-        0xfd2e, 0xed0f, 0xdd6c, 0xcd4d, 0xbdaa, 0xad8b, 0x9de8, 0x8dc9,
-        0x7c26, 0x6c07, 0x5c64, 0x4c45, 0x3ca2, 0x2c83, 0x1ce0, 0x0cc1,
-        0xef1f, 0xff3e, 0xcf5d, 0xdf7c, 0xaf9b, 0xbfba, 0x8fd9, 0x9ff8,
-        0x6e17, 0x7e36, 0x4e55, 0x5e74, 0x2e93, 0x3eb2, 0x0ed1, 0x1ef0
-};
-
 /**
  * crc_ccit
  */
 uint16_t crc_ccit(uint16_t crc, const uint8_t *buf, int size)
 {
-        while (size--) {
-                crc = (crc << 8) ^ crc16_tbl_1021[(crc >> 8 ^ *buf++) & 0xFFU];
-        }
-        return (crc);
+#if CRC_CLMUL == 1
+	if (size >= 64 && crc_clmul_ok()) {
+		return (crc_ccit_clmul(crc, buf, size));
+	}
+#endif
+	return (upd(&crc16_ibm3740, crc, buf, size));
+}
+
+/**
+ * crc_ccit_combine
+ */
+uint16_t crc_ccit_combine(uint16_t crc_a, uint16_t crc_b, unsigned long len_b)
+{
+	return (crc_combine(&crc16_ibm3740, crc_a, crc_b, len_b));
 }
 #endif
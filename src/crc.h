@@ -25,6 +25,218 @@
 #ifndef CRC_CCIT_FUNC
  #define CRC_CCIT_FUNC 0
 #endif
+#ifndef CRC_8_FUNC
+ #define CRC_8_FUNC 0
+#endif
+#ifndef CRC_32_FUNC
+ #define CRC_32_FUNC 0
+#endif
+#ifndef CRC_32C_FUNC
+ #define CRC_32C_FUNC 0
+#endif
+
+// Footprint tier of each polynomial:
+//   CRC_SLICE_BIT - bitwise, no table.
+//   CRC_SLICE_NIB - nibble table, 16 * width / 8 bytes of flash.
+//   1, 4, 8, 16 - number of byte tables, N * 256 * width / 8 bytes of flash.
+//   Slicing by N > 1 processes N bytes per iteration (aligned 32-bit loads).
+#define CRC_SLICE_BIT 0
+#define CRC_SLICE_NIB (-1)
+
+#ifndef CRC_16_SLICE
+ #define CRC_16_SLICE 1
+#endif
+#ifndef CRC_CCIT_SLICE
+ #define CRC_CCIT_SLICE 1
+#endif
+#ifndef CRC_8_SLICE
+ #define CRC_8_SLICE 1
+#endif
+#ifndef CRC_32_SLICE
+ #define CRC_32_SLICE 1
+#endif
+#ifndef CRC_32C_SLICE
+ #define CRC_32C_SLICE 1
+#endif
+
+// Carry-less multiply folding on x86-64 host builds (run time CPUID check).
+#ifndef CRC_CLMUL
+ #define CRC_CLMUL 0
+#endif
+#if CRC_CLMUL == 1 && !defined(__x86_64__)
+ #error "CRC_CLMUL requires x86-64"
+#endif
+
+// Parallel chunked CRC (crc_par()) on host builds.
+#ifndef CRC_PARALLEL
+ #define CRC_PARALLEL 0
+#endif
+#if CRC_PARALLEL == 1
+#ifndef CRC_PARALLEL_MAX_THR
+ #define CRC_PARALLEL_MAX_THR 64
+#endif
+#endif
+
+#if CRC_16_SLICE != CRC_SLICE_BIT && CRC_16_SLICE != CRC_SLICE_NIB && \
+    CRC_16_SLICE != 1 && CRC_16_SLICE != 4 && CRC_16_SLICE != 8 && CRC_16_SLICE != 16
+ #error "CRC_16_SLICE must be CRC_SLICE_BIT, CRC_SLICE_NIB, 1, 4, 8 or 16"
+#endif
+#if CRC_CCIT_SLICE != CRC_SLICE_BIT && CRC_CCIT_SLICE != CRC_SLICE_NIB && \
+    CRC_CCIT_SLICE != 1 && CRC_CCIT_SLICE != 4 && CRC_CCIT_SLICE != 8 && CRC_CCIT_SLICE != 16
+ #error "CRC_CCIT_SLICE must be CRC_SLICE_BIT, CRC_SLICE_NIB, 1, 4, 8 or 16"
+#endif
+#if CRC_8_SLICE != CRC_SLICE_BIT && CRC_8_SLICE != CRC_SLICE_NIB && \
+    CRC_8_SLICE != 1 && CRC_8_SLICE != 4 && CRC_8_SLICE != 8 && CRC_8_SLICE != 16
+ #error "CRC_8_SLICE must be CRC_SLICE_BIT, CRC_SLICE_NIB, 1, 4, 8 or 16"
+#endif
+#if CRC_32_SLICE != CRC_SLICE_BIT && CRC_32_SLICE != CRC_SLICE_NIB && \
+    CRC_32_SLICE != 1 && CRC_32_SLICE != 4 && CRC_32_SLICE != 8 && CRC_32_SLICE != 16
+ #error "CRC_32_SLICE must be CRC_SLICE_BIT, CRC_SLICE_NIB, 1, 4, 8 or 16"
+#endif
+#if CRC_32C_SLICE != CRC_SLICE_BIT && CRC_32C_SLICE != CRC_SLICE_NIB && \
+    CRC_32C_SLICE != 1 && CRC_32C_SLICE != 4 && CRC_32C_SLICE != 8 && CRC_32C_SLICE != 16
+ #error "CRC_32C_SLICE must be CRC_SLICE_BIT, CRC_SLICE_NIB, 1, 4, 8 or 16"
+#endif
+
+/*
+ * CRC model (Rocksoft/Williams parameters). Input and output reflection are
+ * equal for all supported models. Lookup tables are generated by crctbl.py.
+ */
+struct crc_model {
+	const char *nm;
+	int width;         // 8, 16 or 32
+	boolean_t refl;    // Reflected input and output.
+	uint32_t poly;     // Polynomial in normal form (without x^width).
+	uint32_t init;
+	uint32_t xorout;
+	uint32_t check;    // CRC of "123456789".
+	const void *tbl;
+	int slc;           // CRC_*_SLICE tier.
+};
+
+#if CRC_8_FUNC == 1
+extern const struct crc_model crc8_smbus;
+#endif
+#if CRC_16_FUNC == 1
+extern const struct crc_model crc16_arc;      // crc_16(INIT_CRC_16, ...)
+extern const struct crc_model crc16_modbus;   // crc_16(INIT_CRC_16_MODB, ...)
+#endif
+#if CRC_CCIT_FUNC == 1
+extern const struct crc_model crc16_ibm3740;  // crc_ccit(INIT_CRC_CCITT, ...)
+extern const struct crc_model crc16_xmodem;
+#endif
+#if CRC_32_FUNC == 1
+extern const struct crc_model crc32;
+#endif
+#if CRC_32C_FUNC == 1
+extern const struct crc_model crc32c;
+#endif
+
+/**
+ * crc_update
+ *
+ * Update CRC register with data buffer (init and xorout not applied).
+ *
+ * @m: Pointer to CRC model.
+ * @crc: Previous register value (m->init for first buffer).
+ * @buf: Pointer to data buffer.
+ * @size: Size of buffer.
+ *
+ * Returns: Updated register value.
+ */
+uint32_t crc_update(const struct crc_model *m, uint32_t crc, const void *buf, int size);
+
+/**
+ * crc_tbl_size
+ *
+ * Returns: Flash size of model lookup tables in bytes.
+ */
+int crc_tbl_size(const struct crc_model *m);
+
+/**
+ * crc_calc
+ *
+ * Compute CRC of data buffer (init and xorout applied).
+ *
+ * @m: Pointer to CRC model.
+ * @buf: Pointer to data buffer.
+ * @size: Size of buffer.
+ *
+ * Returns: CRC value.
+ */
+uint32_t crc_calc(const struct crc_model *m, const void *buf, int size);
+
+struct crc_seg {
+	const void *p;
+	int len;
+};
+
+/**
+ * crc_update_iov
+ *
+ * Update CRC register with chain of buffers (scatter-gather list) without
+ * copying. Segments may have any length and alignment; each segment is
+ * processed by sliced kernel after its unaligned head.
+ *
+ * @m: Pointer to CRC model.
+ * @crc: Previous register value (m->init for first buffer).
+ * @seg: Pointer to array of segments.
+ * @cnt: Number of segments.
+ *
+ * Returns: Updated register value.
+ */
+uint32_t crc_update_iov(const struct crc_model *m, uint32_t crc, const struct crc_seg *seg, int cnt);
+
+/**
+ * crc_update_ring
+ *
+ * Update CRC register with data stored in ring buffer (data may wrap around
+ * end of ring).
+ *
+ * @m: Pointer to CRC model.
+ * @crc: Previous register value (m->init for first buffer).
+ * @rb: Pointer to start of ring buffer.
+ * @rb_sz: Size of ring buffer.
+ * @ofs: Offset of first data byte in ring buffer.
+ * @len: Number of data bytes (<= rb_sz).
+ *
+ * Returns: Updated register value.
+ */
+uint32_t crc_update_ring(const struct crc_model *m, uint32_t crc, const void *rb, int rb_sz,
+                         int ofs, int len);
+
+/**
+ * crc_combine
+ *
+ * Compute CRC of concatenated buffers A and B from their CRC values
+ * (both computed by crc_calc()). Cost is O(log(len_b)).
+ *
+ * @m: Pointer to CRC model.
+ * @crc_a: CRC of buffer A.
+ * @crc_b: CRC of buffer B.
+ * @len_b: Size of buffer B.
+ *
+ * Returns: CRC of A followed by B.
+ */
+uint32_t crc_combine(const struct crc_model *m, uint32_t crc_a, uint32_t crc_b,
+                     unsigned long len_b);
+
+#if CRC_PARALLEL == 1
+/**
+ * crc_par
+ *
+ * Host builds only (pthreads). Split buffer to nthr chunks, compute their
+ * CRC concurrently and combine results.
+ *
+ * @m: Pointer to CRC model.
+ * @buf: Pointer to data buffer.
+ * @size: Size of buffer.
+ * @nthr: Number of threads (1 - CRC_PARALLEL_MAX_THR).
+ *
+ * Returns: CRC value (as crc_calc()).
+ */
+uint32_t crc_par(const struct crc_model *m, const void *buf, unsigned long size, int nthr);
+#endif
 
 #if CRC_16_FUNC == 1
 #define INIT_CRC_16 0x0000U
@@ -42,6 +254,19 @@
  * Returns: Updated CRC value.
  */
 uint16_t crc_16(uint16_t crc, const uint8_t *buf, int size);
+
+/**
+ * crc_16_combine
+ *
+ * Compute CRC-16 of concatenated buffers A and B.
+ *
+ * @crc_a: crc_16(INIT_CRC_16, A, ...).
+ * @crc_b: crc_16(INIT_CRC_16, B, ...).
+ * @len_b: Size of buffer B.
+ *
+ * Returns: crc_16(INIT_CRC_16, AB, ...).
+ */
+uint16_t crc_16_combine(uint16_t crc_a, uint16_t crc_b, unsigned long len_b);
 #endif
 
 #if CRC_CCIT_FUNC == 1
@@ -59,6 +284,50 @@ uint16_t crc_16(uint16_t crc, const uint8_t *buf, int size);
  * Returns: Updated CRC value.
  */
 uint16_t crc_ccit(uint16_t crc, const uint8_t *buf, int size);
+
+/**
+ * crc_ccit_combine
+ *
+ * Compute CRC-CCIT of concatenated buffers A and B.
+ *
+ * @crc_a: crc_ccit(INIT_CRC_CCITT, A, ...).
+ * @crc_b: crc_ccit(INIT_CRC_CCITT, B, ...).
+ * @len_b: Size of buffer B.
+ *
+ * Returns: crc_ccit(INIT_CRC_CCITT, AB, ...).
+ */
+uint16_t crc_ccit_combine(uint16_t crc_a, uint16_t crc_b, unsigned long len_b);
+#endif
+
+#if CRC_CLMUL == 1
+/**
+ * crc_clmul_ok
+ *
+ * Returns: TRUE if CPU supports PCLMULQDQ and SSSE3.
+ */
+boolean_t crc_clmul_ok(void);
+
+#if CRC_16_FUNC == 1
+/**
+ * crc_16_clmul
+ *
+ * PCLMULQDQ variant of crc_16(). Falls back to table code for buffers
+ * shorter than 64 bytes or if CPU lacks PCLMULQDQ. crc_16() calls it
+ * automatically.
+ */
+uint16_t crc_16_clmul(uint16_t crc, const uint8_t *buf, int size);
+#endif
+
+#if CRC_CCIT_FUNC == 1
+/**
+ * crc_ccit_clmul
+ *
+ * PCLMULQDQ variant of crc_ccit(). Falls back to table code for buffers
+ * shorter than 64 bytes or if CPU lacks PCLMULQDQ. crc_ccit() calls it
+ * automatically.
+ */
+uint16_t crc_ccit_clmul(uint16_t crc, const uint8_t *buf, int size);
+#endif
 #endif
 
 #endif
@@ -0,0 +1,147 @@
+#!/usr/bin/env python3
+#
+# crctbl.py
+#
+# Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+#
+# Permission to use, copy, modify, and distribute this software for any
+# purpose with or without fee is hereby granted, provided that the above
+# copyright notice and this permission notice appear in all copies.
+#
+# THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+# WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+# MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+# ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+# WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+# ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+# OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+#
+# Generates crctbl.h (lookup tables for crc.c).
+# Usage: python3 crctbl.py > crctbl.h
+
+import sys
+
+SLICES = (1, 4, 8, 16)
+
+# (table name, enable macro, slice macro, width, poly, reflected, comment)
+TABLES = (
+    ("crc8_tbl_07", "CRC_8_FUNC", "CRC_8_SLICE", 8, 0x07, False,
+     "CRC-8. Poly is 0x07 (x^8 + x^2 + x + 1)."),
+    ("crc16_tbl_8005", "CRC_16_FUNC", "CRC_16_SLICE", 16, 0x8005, True,
+     "CRC-16. Poly is 0x8005 (x^16 + x^15 + x^2 + 1), reflected."),
+    ("crc16_tbl_1021", "CRC_CCIT_FUNC", "CRC_CCIT_SLICE", 16, 0x1021, False,
+     "CRC-CCITT. Poly is 0x1021 (x^16 + x^12 + x^5 + 1)."),
+    ("crc32_tbl_04C11DB7", "CRC_32_FUNC", "CRC_32_SLICE", 32, 0x04C11DB7, True,
+     "CRC-32. Poly is 0x04C11DB7 (IEEE 802.3), reflected."),
+    ("crc32_tbl_1EDC6F41", "CRC_32C_FUNC", "CRC_32C_SLICE", 32, 0x1EDC6F41, True,
+     "CRC-32C. Poly is 0x1EDC6F41 (Castagnoli), reflected."),
+)
+
+
+def reflect(v, w):
+    r = 0
+    for _ in range(w):
+        r = (r << 1) | (v & 1)
+        v >>= 1
+    return r
+
+
+def byte_table(w, poly, refl):
+    msk = (1 << w) - 1
+    tbl = []
+    if refl:
+        rp = reflect(poly, w)
+        for i in range(256):
+            c = i
+            for _ in range(8):
+                c = (c >> 1) ^ rp if c & 1 else c >> 1
+            tbl.append(c)
+    else:
+        top = 1 << (w - 1)
+        for i in range(256):
+            c = i << (w - 8)
+            for _ in range(8):
+                c = ((c << 1) ^ poly if c & top else c << 1) & msk
+            tbl.append(c)
+    return tbl
+
+
+def nibble_table(w, poly, refl):
+    msk = (1 << w) - 1
+    tbl = []
+    if refl:
+        rp = reflect(poly, w)
+        for i in range(16):
+            c = i
+            for _ in range(4):
+                c = (c >> 1) ^ rp if c & 1 else c >> 1
+            tbl.append(c)
+    else:
+        top = 1 << (w - 1)
+        for i in range(16):
+            c = i << (w - 4)
+            for _ in range(4):
+                c = ((c << 1) ^ poly if c & top else c << 1) & msk
+            tbl.append(c)
+    return tbl
+
+
+def slice_tables(w, poly, refl, n):
+    msk = (1 << w) - 1
+    t = [byte_table(w, poly, refl)]
+    for k in range(1, n):
+        p = t[k - 1]
+        if refl:
+            t.append([(v >> 8) ^ t[0][v & 0xFF] for v in p])
+        else:
+            t.append([((v << 8) & msk) ^ t[0][v >> (w - 8)] for v in p])
+    return t
+
+
+def emit_table(out, vals, w):
+    dig = w // 4
+    per = 8 if w <= 16 else 4
+    out.write("\t{\n")
+    for i in range(0, 256, per):
+        out.write("\t\t" + ", ".join("0x%0*X" % (dig, v)
+                                      for v in vals[i:i + per]))
+        out.write(",\n" if i + per < 256 else "\n")
+    out.write("\t},\n")
+
+
+def main():
+    out = sys.stdout
+    out.write("/*\n * crctbl.h\n *\n"
+              " * Generated by crctbl.py, do not edit.\n */\n\n"
+              "#ifndef CRCTBL_H\n#define CRCTBL_H\n")
+    for nm, en, slc, w, poly, refl, cmt in TABLES:
+        t = slice_tables(w, poly, refl, SLICES[-1])
+        typ = "uint%d_t" % (8 if w <= 8 else 16 if w <= 16 else 32)
+        out.write("\n#if %s == 1\n" % en)
+        out.write("// %s\n" % cmt)
+        out.write("#if %s == CRC_SLICE_NIB\n" % slc)
+        out.write("// Nibble table (4 bits per lookup).\n")
+        out.write("static const %s %s[16] = {\n" % (typ, nm.replace("_tbl_", "_nib_")))
+        nt = nibble_table(w, poly, refl)
+        for i in range(0, 16, 8):
+            out.write("\t" + ", ".join("0x%0*X" % (w // 4, v) for v in nt[i:i + 8]))
+            out.write(",\n" if i + 8 < 16 else "\n")
+        out.write("};\n")
+        out.write("#elif %s >= 1\n" % slc)
+        out.write("// Table k gives CRC of byte followed by k zero bytes.\n")
+        out.write("static const %s %s[%s][256] = {\n" % (typ, nm, slc))
+        prev = 0
+        for s in SLICES:
+            if prev:
+                out.write("#if %s >= %d\n" % (slc, s))
+            for k in range(prev, s):
+                emit_table(out, t[k], w)
+            if prev:
+                out.write("#endif\n")
+            prev = s
+        out.write("};\n#endif\n#endif\n")
+    out.write("\n#endif\n")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,221 @@
+/*
+ * crcx86.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Carry-less multiply (PCLMULQDQ) folding for host builds.
+ *
+ * Buffer is treated as polynomial over GF(2). Four 128-bit accumulators
+ * are folded forward by 512 bits (A * x^512 mod P computed as two 64x64 bit
+ * carry-less products with constants x^(512+64) mod P and x^512 mod P),
+ * then merged by 128-bit folds. Folding keeps the remainder modulo P, so
+ * CRC of the last 16 byte accumulator (computed by table code from zero)
+ * equals CRC of the whole folded part. Reflected CRC keeps bytes in memory
+ * order (bit 0 of integer is highest power), constants are bit reversed
+ * and decreased by one power (product of two reflected values is shifted
+ * by one bit).
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "crc.h"
+
+#if CRC_CLMUL == 1 && (CRC_16_FUNC == 1 || CRC_CCIT_FUNC == 1)
+
+#include <immintrin.h>
+
+#define CLMUL_TGT __attribute__((target("pclmul,ssse3")))
+
+static int sup;
+#if CRC_16_FUNC == 1
+static uint64_t k16[4];
+#endif
+#if CRC_CCIT_FUNC == 1
+static uint64_t kcc[4];
+#endif
+
+static uint64_t xpow_mod(int n, uint32_t p, int w);
+static uint64_t rev64(uint64_t v);
+
+/**
+ * crc_clmul_ok
+ */
+boolean_t crc_clmul_ok(void)
+{
+	if (sup == 0) {
+#if CRC_16_FUNC == 1
+		k16[0] = rev64(xpow_mod(575, 0x8005, 16));
+		k16[1] = rev64(xpow_mod(511, 0x8005, 16));
+		k16[2] = rev64(xpow_mod(191, 0x8005, 16));
+		k16[3] = rev64(xpow_mod(127, 0x8005, 16));
+#endif
+#if CRC_CCIT_FUNC == 1
+		kcc[0] = xpow_mod(512, 0x1021, 16);
+		kcc[1] = xpow_mod(576, 0x1021, 16);
+		kcc[2] = xpow_mod(128, 0x1021, 16);
+		kcc[3] = xpow_mod(192, 0x1021, 16);
+#endif
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("pclmul") && __builtin_cpu_supports("ssse3")) {
+			sup = 1;
+		} else {
+			sup = -1;
+		}
+	}
+	return (sup > 0 ? TRUE : FALSE);
+}
+
+/**
+ * xpow_mod
+ *
+ * x^n mod P, P given without x^w term.
+ */
+static uint64_t xpow_mod(int n, uint32_t p, int w)
+{
+	uint64_t r = 1, top = (uint64_t) 1 << w;
+
+	while (n--) {
+		r <<= 1;
+		if (r & top) {
+			r ^= top | p;
+		}
+	}
+	return (r);
+}
+
+/**
+ * rev64
+ */
+static uint64_t rev64(uint64_t v)
+{
+	uint64_t r = 0;
+
+	for (int i = 0; i < 64; i++) {
+		r = (r << 1) | (v & 1);
+		v >>= 1;
+	}
+	return (r);
+}
+
+/**
+ * fold
+ */
+static inline CLMUL_TGT __m128i fold(__m128i a, __m128i k, __m128i d)
+{
+	return (_mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(a, k, 0x00),
+	                                    _mm_clmulepi64_si128(a, k, 0x11)), d));
+}
+
+/**
+ * fold_buf
+ *
+ * Fold buffer (size >= 64) to one 128-bit remainder.
+ *
+ * @sw: Byte swap mask (big endian bit order) or NULL (reflected).
+ *
+ * Returns: Number of folded bytes (multiple of 16).
+ */
+static CLMUL_TGT int fold_buf(const uint64_t *k, const __m128i *sw, __m128i ini,
+                              const uint8_t *buf, int size, uint8_t *out)
+{
+	__m128i a0, a1, a2, a3, k512, k128;
+	const __m128i *p = (const __m128i *) buf;
+	int n = 64;
+
+	k512 = _mm_set_epi64x(k[1], k[0]);
+	k128 = _mm_set_epi64x(k[3], k[2]);
+	a0 = _mm_loadu_si128(p++);
+	a1 = _mm_loadu_si128(p++);
+	a2 = _mm_loadu_si128(p++);
+	a3 = _mm_loadu_si128(p++);
+	if (sw) {
+		a0 = _mm_shuffle_epi8(a0, *sw);
+		a1 = _mm_shuffle_epi8(a1, *sw);
+		a2 = _mm_shuffle_epi8(a2, *sw);
+		a3 = _mm_shuffle_epi8(a3, *sw);
+	}
+	a0 = _mm_xor_si128(a0, ini);
+	for (; n + 64 <= size; n += 64) {
+		__m128i d0 = _mm_loadu_si128(p++);
+		__m128i d1 = _mm_loadu_si128(p++);
+		__m128i d2 = _mm_loadu_si128(p++);
+		__m128i d3 = _mm_loadu_si128(p++);
+		if (sw) {
+			d0 = _mm_shuffle_epi8(d0, *sw);
+			d1 = _mm_shuffle_epi8(d1, *sw);
+			d2 = _mm_shuffle_epi8(d2, *sw);
+			d3 = _mm_shuffle_epi8(d3, *sw);
+		}
+		a0 = fold(a0, k512, d0);
+		a1 = fold(a1, k512, d1);
+		a2 = fold(a2, k512, d2);
+		a3 = fold(a3, k512, d3);
+	}
+	a1 = fold(a0, k128, a1);
+	a2 = fold(a1, k128, a2);
+	a0 = fold(a2, k128, a3);
+	for (; n + 16 <= size; n += 16) {
+		__m128i d = _mm_loadu_si128(p++);
+		if (sw) {
+			d = _mm_shuffle_epi8(d, *sw);
+		}
+		a0 = fold(a0, k128, d);
+	}
+	if (sw) {
+		a0 = _mm_shuffle_epi8(a0, *sw);
+	}
+	_mm_storeu_si128((__m128i *) out, a0);
+	return (n);
+}
+
+#if CRC_16_FUNC == 1
+/**
+ * crc_16_clmul
+ */
+CLMUL_TGT uint16_t crc_16_clmul(uint16_t crc, const uint8_t *buf, int size)
+{
+	uint8_t r[16];
+	int n;
+
+	if (size < 64 || !crc_clmul_ok()) {
+		return (crc_16(crc, buf, size));
+	}
+	n = fold_buf(k16, NULL, _mm_cvtsi32_si128(crc), buf, size, r);
+	return (crc_16(crc_16(0, r, 16), buf + n, size - n));
+}
+#endif
+
+#if CRC_CCIT_FUNC == 1
+/**
+ * crc_ccit_clmul
+ */
+CLMUL_TGT uint16_t crc_ccit_clmul(uint16_t crc, const uint8_t *buf, int size)
+{
+	__m128i sw;
+	uint8_t r[16];
+	int n;
+
+	if (size < 64 || !crc_clmul_ok()) {
+		return (crc_ccit(crc, buf, size));
+	}
+	sw = _mm_set_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+	n = fold_buf(kcc, &sw, _mm_set_epi64x((uint64_t) crc << 48, 0), buf, size, r);
+	return (crc_ccit(crc_ccit(0, r, 16), buf + n, size - n));
+}
+#endif
+#endif
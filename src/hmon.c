@@ -0,0 +1,390 @@
+/*
+ * hmon.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#include "ramnfo.h"
+#include "hmon.h"
+#include <limits.h>
+#include <stdio.h>
+#include <string.h>
+
+#if HMON == 1
+
+#if TERMOUT != 1
+ #error "hmon.c depends on tout.c"
+#endif
+
+// Task handles are kept between steps, task creates and deletes are counted.
+#if RAMNFO_TASK_STACKS == 1
+ #if RAMNFO_TASK_GEN != 1
+  #error "hmon.c requires RAMNFO_TASK_GEN"
+ #endif
+ #define TSK_GEN() ramnfo_tsk_gen
+#else
+ #define TSK_GEN() 0U
+#endif
+
+static const char *const tsk_nm = "HMON";
+static struct stack_nfo st[RAMNFO_MAX_STACKS];
+static int nst, nx, ntsk;
+static unsigned int gen;
+static boolean_t ovf;
+// Alerts found with scheduler suspended.
+static struct {
+	char nm[configMAX_TASK_NAME_LEN];
+	int mrg;
+} pnd[HMON_STACKS_PER_STEP];
+// Stacks already reported (margin at last alert).
+static struct {
+	unsigned char *lo;
+	int mrg;
+} alr[RAMNFO_MAX_STACKS];
+static boolean_t heap_alr, blk_alr;
+#if RAMNFO_HEAP_GEN != 1
+static boolean_t frg_alr;
+#endif
+static struct hmon_rec cur, hist[HMON_HIST_SIZE];
+static int hist_pos, hist_cnt;
+
+static void hmon_tsk(void *p);
+static void step(void);
+static void list(void);
+static void new_round(void);
+static void end_round(void);
+static void heap_smp(void);
+static void task_smp(void);
+static boolean_t stack_chk(struct stack_nfo *nfo);
+static void clr_alr(void);
+
+/**
+ * init_hmon
+ */
+void init_hmon(void)
+{
+	if (pdPASS != xTaskCreate(hmon_tsk, tsk_nm, HMON_STACK_SIZE, NULL,
+				  HMON_TASK_PRIO, NULL)) {
+		crit_err_exit(MALLOC_ERROR);
+	}
+}
+
+/**
+ * hmon_tsk
+ */
+static void hmon_tsk(void *p)
+{
+	TickType_t tm;
+
+	clr_alr();
+	vTaskSuspendAll();
+	list();
+	xTaskResumeAll();
+	new_round();
+	tm = xTaskGetTickCount();
+	while (TRUE) {
+		vTaskDelayUntil(&tm, pdMS_TO_TICKS(HMON_PERIOD_MS));
+		step();
+	}
+}
+
+/**
+ * step
+ */
+static void step(void)
+{
+	int n = ntsk, na = 0;
+	boolean_t chg;
+
+	vTaskSuspendAll();
+	if ((chg = gen != TSK_GEN() || ntsk != (int) uxTaskGetNumberOfTasks())) {
+		list();
+		nx = 0;
+		cur.ntsk = ntsk;
+		clr_alr();
+	}
+	task_smp();
+	for (int i = 0; i < HMON_STACKS_PER_STEP && nx < nst; i++, nx++) {
+		if (stack_chk(&st[nx])) {
+			strcpy(pnd[na].nm, st[nx].nm);
+			pnd[na++].mrg = st[nx].margin;
+		}
+	}
+	xTaskResumeAll();
+	if (chg) {
+		add_msg_tout("hmon: tasks %d -> %d\n", n, ntsk);
+		if (ovf) {
+			add_msg_tout("hmon: more than %d tasks, task stacks not checked\n",
+			             RAMNFO_MAX_TASKS);
+		}
+	}
+	for (int i = 0; i < na; i++) {
+		add_msg_tout("hmon: stack %s margin=%d\n", pnd[i].nm, pnd[i].mrg);
+	}
+	heap_smp();
+	if (nx == nst) {
+		end_round();
+		new_round();
+	}
+}
+
+/**
+ * list
+ *
+ * Stack descriptors are kept across rounds, task handles are valid until
+ * task generation changes (scheduler must be suspended).
+ */
+static void list(void)
+{
+	gen = TSK_GEN();
+	ntsk = uxTaskGetNumberOfTasks();
+	nst = stack_list(st, RAMNFO_MAX_STACKS);
+	if ((ovf = nst < 0)) {
+		nst = -nst;
+	}
+}
+
+/**
+ * new_round
+ */
+static void new_round(void)
+{
+	nx = 0;
+	cur.heap_smp = 0;
+	cur.heap_part = 0;
+	cur.heap_min = INT_MAX;
+	cur.heap_max = 0;
+	cur.blk_min = INT_MAX;
+	cur.stk_min = INT_MAX;
+	cur.stk_nm[0] = '\0';
+	cur.ntsk = ntsk;
+	cur.tsk_rdy = 0;
+	cur.tsk_blk = 0;
+	cur.tsk_susp = 0;
+}
+
+/**
+ * end_round
+ */
+static void end_round(void)
+{
+	cur.tm = xTaskGetTickCount();
+	vTaskSuspendAll();
+	hist[hist_pos] = cur;
+	hist_pos = (hist_pos + 1) % HMON_HIST_SIZE;
+	if (hist_cnt < HMON_HIST_SIZE) {
+		hist_cnt++;
+	}
+	xTaskResumeAll();
+}
+
+/**
+ * heap_smp
+ *
+ * Only finished walks are recorded and checked, partial walk gives lower
+ * bounds.
+ */
+static void heap_smp(void)
+{
+	int fre, blk;
+#if RAMNFO_HEAP_GEN == 1
+	static struct heap_walk w;
+
+	if (!heap_walk(&w, HMON_HEAP_MAX_BLOCKS)) {
+		return;
+	}
+	fre = w.hi.total;
+	blk = w.hi.largest;
+#else
+	struct heap_info hi;
+
+	heap_info(&hi, NULL, 0, HMON_HEAP_MAX_BLOCKS);
+	if (hi.partial) {
+		cur.heap_part++;
+		if (!frg_alr) {
+			add_msg_tout("hmon: heap blocks>%d\n", HMON_HEAP_MAX_BLOCKS);
+			frg_alr = TRUE;
+		}
+		return;
+	}
+	frg_alr = FALSE;
+	fre = hi.total;
+	blk = hi.largest;
+#endif
+	cur.heap_smp++;
+	if (fre < cur.heap_min) {
+		cur.heap_min = fre;
+	}
+	if (fre > cur.heap_max) {
+		cur.heap_max = fre;
+	}
+	if (blk < cur.blk_min) {
+		cur.blk_min = blk;
+	}
+	if (fre < HMON_HEAP_FREE) {
+		if (!heap_alr) {
+			add_msg_tout("hmon: heap free=%d\n", fre);
+			heap_alr = TRUE;
+		}
+	} else {
+		heap_alr = FALSE;
+	}
+	if (blk < HMON_HEAP_BLOCK) {
+		if (!blk_alr) {
+			add_msg_tout("hmon: heap block=%d\n", blk);
+			blk_alr = TRUE;
+		}
+	} else {
+		blk_alr = FALSE;
+	}
+}
+
+/**
+ * task_smp
+ */
+static void task_smp(void)
+{
+	int rdy = 0, blk = 0, susp = 0;
+
+	for (int i = 0; i < nst; i++) {
+		if (st[i].tsk == NULL) {
+			continue;
+		}
+		switch (eTaskGetState(st[i].tsk)) {
+		case eRunning :
+			/* FALLTHRU */
+		case eReady :
+			rdy++;
+			break;
+		case eBlocked :
+			blk++;
+			break;
+		case eSuspended :
+			susp++;
+			break;
+		default :
+			break;
+		}
+	}
+	if (rdy > cur.tsk_rdy) {
+		cur.tsk_rdy = rdy;
+	}
+	cur.tsk_blk = blk;
+	cur.tsk_susp = susp;
+}
+
+/**
+ * stack_chk
+ *
+ * Returns: TRUE - alert.
+ */
+static boolean_t stack_chk(struct stack_nfo *nfo)
+{
+	int i, fre = -1;
+
+	stack_scan(nfo);
+	if (nfo->margin < cur.stk_min) {
+		cur.stk_min = nfo->margin;
+		strncpy(cur.stk_nm, nfo->nm, configMAX_TASK_NAME_LEN - 1);
+		cur.stk_nm[configMAX_TASK_NAME_LEN - 1] = '\0';
+	}
+	if (nfo->margin >= HMON_STACK_MARGIN) {
+		return (FALSE);
+	}
+	// Stack margin can only shrink, report stack again only if it does.
+	for (i = 0; i < RAMNFO_MAX_STACKS; i++) {
+		if (alr[i].lo == nfo->lo) {
+			break;
+		}
+		if (fre < 0 && alr[i].lo == NULL) {
+			fre = i;
+		}
+	}
+	if (i == RAMNFO_MAX_STACKS) {
+		if (fre < 0) {
+			return (FALSE);
+		}
+		i = fre;
+		alr[i].lo = nfo->lo;
+	}
+	if (nfo->margin < alr[i].mrg) {
+		alr[i].mrg = nfo->margin;
+		return (TRUE);
+	}
+	return (FALSE);
+}
+
+/**
+ * clr_alr
+ *
+ * Stacks may be reused by new tasks, forget reported ones.
+ */
+static void clr_alr(void)
+{
+	for (int i = 0; i < RAMNFO_MAX_STACKS; i++) {
+		alr[i].lo = NULL;
+		alr[i].mrg = INT_MAX;
+	}
+}
+
+/**
+ * hmon_hist
+ */
+int hmon_hist(struct hmon_rec *rec, int n)
+{
+	int i;
+
+	vTaskSuspendAll();
+	for (i = 0; i < n && i < hist_cnt; i++) {
+		rec[i] = hist[(hist_pos + HMON_HIST_SIZE - 1 - i) % HMON_HIST_SIZE];
+	}
+	xTaskResumeAll();
+	return (i);
+}
+
+/**
+ * print_hmon
+ */
+void print_hmon(void)
+{
+	static struct hmon_rec rec[HMON_HIST_SIZE];
+	char hp[28];
+	int n;
+
+	n = hmon_hist(rec, HMON_HIST_SIZE);
+	msg(INF, "      tick heap_min heap_max  blk_min walk part  stk_min stack"
+	    "            tasks rdy blk susp\n");
+	for (int i = 0; i < n; i++) {
+		if (rec[i].heap_smp) {
+			snprintf(hp, sizeof(hp), "%8d %8d %8d", rec[i].heap_min,
+			         rec[i].heap_max, rec[i].blk_min);
+		} else {
+			strcpy(hp, "       -        -        -");
+		}
+		msg(INF, "%10u %s %4d %4d %8d %-16.16s %5d %3d %3d %4d\n",
+		    (unsigned int) rec[i].tm, hp, rec[i].heap_smp, rec[i].heap_part,
+		    rec[i].stk_min, rec[i].stk_nm, rec[i].ntsk, rec[i].tsk_rdy,
+		    rec[i].tsk_blk, rec[i].tsk_susp);
+	}
+}
+#endif
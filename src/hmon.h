@@ -0,0 +1,124 @@
+/*
+ * hmon.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef HMON_H
+#define HMON_H
+
+#ifndef HMON
+ #define HMON 0
+#endif
+
+#if HMON == 1
+
+// Sampling period.
+#ifndef HMON_PERIOD_MS
+ #define HMON_PERIOD_MS 1000
+#endif
+
+// Stacks scanned per period (one round covers all stacks).
+#ifndef HMON_STACKS_PER_STEP
+ #define HMON_STACKS_PER_STEP 1
+#endif
+
+// Alert thresholds in bytes (0 - disabled).
+#ifndef HMON_STACK_MARGIN
+ #define HMON_STACK_MARGIN 64
+#endif
+
+#ifndef HMON_HEAP_FREE
+ #define HMON_HEAP_FREE 1024
+#endif
+
+#ifndef HMON_HEAP_BLOCK
+ #define HMON_HEAP_BLOCK 256
+#endif
+
+/*
+ * Maximum number of free blocks walked per period. With RAMNFO_HEAP_GEN
+ * walk continues in next period (heap_walk()), otherwise longer free list
+ * gives partial sample and fragmentation alert.
+ */
+#ifndef HMON_HEAP_MAX_BLOCKS
+ #define HMON_HEAP_MAX_BLOCKS 64
+#endif
+
+// History ring size (records).
+#ifndef HMON_HIST_SIZE
+ #define HMON_HIST_SIZE 8
+#endif
+
+#ifndef HMON_TASK_PRIO
+ #define HMON_TASK_PRIO (tskIDLE_PRIORITY + 1)
+#endif
+
+// One record per round (all stacks scanned).
+struct hmon_rec {
+	TickType_t tm;
+	int heap_smp; // Finished heap walks, heap values are valid if > 0.
+	int heap_part; // Partial heap walks (not used in heap values).
+	int heap_min;
+	int heap_max;
+	int blk_min;
+	int stk_min;
+	char stk_nm[configMAX_TASK_NAME_LEN];
+	int ntsk;
+	int tsk_rdy; // Max tasks ready or running in one sample.
+	int tsk_blk; // Blocked tasks in last sample.
+	int tsk_susp; // Suspended tasks in last sample.
+};
+
+/**
+ * init_hmon
+ *
+ * Create health monitor task (HMON_STACK_SIZE, HMON_TASK_PRIO). Every
+ * HMON_PERIOD_MS task walks heap free list (at most HMON_HEAP_MAX_BLOCKS
+ * free blocks) for free heap and largest free block, samples task states
+ * (eTaskGetState(),
+ * INCLUDE_eTaskGetState must be set) and scans HMON_STACKS_PER_STEP stacks
+ * (stack_scan()), so time spent in one period is bounded. Stacks are
+ * listed (stack_list()) at start and when tasks are created or deleted
+ * (RAMNFO_TASK_GEN must be set if task stacks are listed), task states
+ * are read and stacks scanned with scheduler suspended, so task handles
+ * are never stale. Alerts are logged by add_msg_tout() when stack margin,
+ * free heap or largest block of finished walk falls below its threshold
+ * (once per crossing), when partial walk finds fragmented heap and when
+ * tasks are created or deleted.
+ */
+void init_hmon(void);
+
+/**
+ * hmon_hist
+ *
+ * Copy history records (min/max values of finished rounds), newest first.
+ *
+ * @rec: Output array.
+ * @n: Array size.
+ *
+ * Returns: Number of copied records.
+ */
+int hmon_hist(struct hmon_rec *rec, int n);
+
+#if TERMOUT == 1
+/**
+ * print_hmon
+ */
+void print_hmon(void);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,330 @@
+/*
+ * mtrack.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "msgconf.h"
+#include "fmalloc.h"
+#include "pool.h"
+#include "tcmd.h"
+#include "mtrack.h"
+#include <string.h>
+
+#if MTRACK == 1
+
+#if MTRACK_SIZE & (MTRACK_SIZE - 1)
+ #error "MTRACK_SIZE must be power of 2"
+#endif
+
+#if MTRACK_WRAP_MALLOC == 1
+#if POOL == 1 && POOL_WRAP_MALLOC == 1
+ #error "POOL_WRAP_MALLOC with MTRACK_WRAP_MALLOC (tracking wraps pool_malloc())"
+#endif
+void *__real_pvPortMalloc(size_t size);
+void __real_vPortFree(void *p);
+void *__wrap_pvPortMalloc(size_t size);
+void __wrap_vPortFree(void *p);
+#if POOL == 1 && POOL_MALLOC == 1
+ #define ALLOC(size) pool_malloc(size)
+ #define FREE(p) pool_mfree(p)
+#else
+ #define ALLOC(size) __real_pvPortMalloc(size)
+ #define FREE(p) __real_vPortFree(p)
+#endif
+#endif
+
+#define MSK (MTRACK_SIZE - 1)
+
+/*
+ * Entries are kept within MTRACK_MAX_PROBE slots from home slot, lookup
+ * scans this window only, so free slot needs no tombstone.
+ */
+static struct ent {
+	void *p;
+	void *caller;
+	TaskHandle_t tsk;
+	uint32_t seq;
+	uint32_t size;
+} tbl[MTRACK_SIZE];
+
+static uint32_t seq, mark;
+static struct mtrack_stats sts;
+#if TERMOUT == 1
+static TaskStatus_t ts[MTRACK_TASKS];
+static char ts_nm[MTRACK_TASKS][configMAX_TASK_NAME_LEN];
+#endif
+
+static unsigned int hash(const void *p);
+#if TERMOUT == 1
+static const char *tsk_nm(TaskHandle_t t, int n);
+#endif
+
+/**
+ * mtrack_alloc
+ */
+void mtrack_alloc(void *p, size_t size, void *caller)
+{
+	struct ent *e = NULL;
+	TaskHandle_t t;
+	unsigned int h;
+	int i;
+
+	if (p == NULL) {
+		return;
+	}
+	h = hash(p);
+	// First created task is current one before scheduler starts.
+	if (xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED) {
+		t = NULL;
+	} else {
+		t = xTaskGetCurrentTaskHandle();
+	}
+	taskENTER_CRITICAL();
+	for (i = 0; i < MTRACK_MAX_PROBE; i++) {
+		if (tbl[(h + i) & MSK].p == NULL) {
+			e = &tbl[(h + i) & MSK];
+			break;
+		}
+	}
+	sts.ops++;
+	if (e) {
+		e->p = p;
+		e->caller = caller;
+		e->seq = seq++;
+		e->size = size;
+		e->tsk = t;
+		if (++sts.live > sts.peak) {
+			sts.peak = sts.live;
+		}
+		i++;
+	} else {
+		sts.lost++;
+	}
+	sts.probes += i;
+	if (i > sts.max_probe) {
+		sts.max_probe = i;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * mtrack_free
+ */
+void mtrack_free(void *p)
+{
+	unsigned int h;
+	int i;
+
+	if (p == NULL) {
+		return;
+	}
+	h = hash(p);
+	taskENTER_CRITICAL();
+	for (i = 0; i < MTRACK_MAX_PROBE; i++) {
+		if (tbl[(h + i) & MSK].p == p) {
+			tbl[(h + i) & MSK].p = NULL;
+			sts.live--;
+			break;
+		}
+	}
+	sts.ops++;
+	if (i == MTRACK_MAX_PROBE) {
+		sts.unknown++;
+	} else {
+		i++;
+	}
+	sts.probes += i;
+	if (i > sts.max_probe) {
+		sts.max_probe = i;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * mtrack_mark
+ */
+void mtrack_mark(void)
+{
+	taskENTER_CRITICAL();
+	mark = seq;
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * mtrack_sites
+ */
+int mtrack_sites(struct mtrack_site *site, int n, boolean_t diff)
+{
+	struct mtrack_site t;
+	struct ent *e;
+	int k = 0, j;
+
+	if (n < 1) {
+		return (0);
+	}
+	// Allocation needs scheduler, table is stable while suspended.
+	vTaskSuspendAll();
+	for (e = tbl; e < tbl + MTRACK_SIZE; e++) {
+		if (e->p == NULL || (diff && (int32_t) (e->seq - mark) < 0)) {
+			continue;
+		}
+		for (j = 0; j < k; j++) {
+			if (site[j].caller == e->caller && site[j].tsk == e->tsk) {
+				break;
+			}
+		}
+		if (j == k) {
+			if (k < n) {
+				site[k].caller = e->caller;
+				site[k].tsk = e->tsk;
+				site[k].count = 0;
+				site[k++].bytes = 0;
+			} else {
+				j = n - 1;
+				site[j].caller = NULL;
+				site[j].tsk = NULL;
+			}
+		}
+		site[j].count++;
+		site[j].bytes += e->size;
+	}
+	xTaskResumeAll();
+	for (int i = 1; i < k; i++) {
+		t = site[i];
+		for (j = i; j > 0 && site[j - 1].bytes < t.bytes; j--) {
+			site[j] = site[j - 1];
+		}
+		site[j] = t;
+	}
+	return (k);
+}
+
+/**
+ * mtrack_get_stats
+ */
+void mtrack_get_stats(struct mtrack_stats *st)
+{
+	taskENTER_CRITICAL();
+	*st = sts;
+	taskEXIT_CRITICAL();
+}
+
+/**
+ * hash
+ */
+static unsigned int hash(const void *p)
+{
+	uint32_t h = (uintptr_t) p >> 3;
+
+	h *= 0x9E3779B1U;
+	return ((h ^ (h >> 16)) & MSK);
+}
+
+#if MTRACK_WRAP_MALLOC == 1
+/**
+ * __wrap_pvPortMalloc
+ */
+void *__wrap_pvPortMalloc(size_t size)
+{
+	void *p;
+
+	p = ALLOC(size);
+	mtrack_alloc(p, size, __builtin_return_address(0));
+	return (p);
+}
+
+/**
+ * __wrap_vPortFree
+ */
+void __wrap_vPortFree(void *p)
+{
+	mtrack_free(p);
+	FREE(p);
+}
+#endif
+
+#if TERMOUT == 1
+/**
+ * print_mtrack
+ */
+void print_mtrack(boolean_t diff)
+{
+	static struct mtrack_site site[MTRACK_SITES];
+	struct mtrack_stats st;
+	int n, nt = 0;
+
+	n = mtrack_sites(site, MTRACK_SITES, diff);
+	mtrack_get_stats(&st);
+#if configUSE_TRACE_FACILITY == 1
+	// Names are copied, task may be deleted while output waits.
+	vTaskSuspendAll();
+	nt = uxTaskGetSystemState(ts, MTRACK_TASKS, NULL);
+	for (int i = 0; i < nt; i++) {
+		strncpy(ts_nm[i], ts[i].pcTaskName, configMAX_TASK_NAME_LEN - 1);
+		ts_nm[i][configMAX_TASK_NAME_LEN - 1] = '\0';
+	}
+	xTaskResumeAll();
+#endif
+	msg(INF, "mtrack.c: live=%d peak=%d lost=%u unkn=%u ops=%u prb=%u maxprb=%d\n",
+	    st.live, st.peak, st.lost, st.unknown, st.ops, st.probes, st.max_probe);
+	msg(INF, "caller     task             count  bytes\n");
+	for (int i = 0; i < n; i++) {
+		msg(INF, "%-10p %-16.16s %5d %6d\n", site[i].caller, tsk_nm(site[i].tsk, nt),
+		    site[i].count, site[i].bytes);
+	}
+}
+
+/**
+ * tsk_nm
+ */
+static const char *tsk_nm(TaskHandle_t t, int n)
+{
+	if (t == NULL) {
+		return ("-");
+	}
+	for (int i = 0; i < n; i++) {
+		if (ts[i].xHandle == t) {
+			return (ts_nm[i]);
+		}
+	}
+	return ("?");
+}
+#endif
+
+#if defined(TERMCMD) && TERMCMD == 1
+/**
+ * mtrack_cmd
+ */
+int mtrack_cmd(int argc, char **argv)
+{
+	if (argc == 1) {
+		print_mtrack(FALSE);
+	} else if (argc == 2 && !strcmp(argv[1], "mark")) {
+		mtrack_mark();
+	} else if (argc == 2 && !strcmp(argv[1], "diff")) {
+		print_mtrack(TRUE);
+	} else {
+		return (1);
+	}
+	return (0);
+}
+#endif
+#endif
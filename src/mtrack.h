@@ -0,0 +1,155 @@
+/*
+ * mtrack.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef MTRACK_H
+#define MTRACK_H
+
+#ifndef MTRACK
+ #define MTRACK 0
+#endif
+
+#if MTRACK == 1
+
+// Hash table size (live allocations, power of 2).
+#ifndef MTRACK_SIZE
+ #define MTRACK_SIZE 256
+#endif
+
+// Maximum probe length (bounds time of record and lookup).
+#ifndef MTRACK_MAX_PROBE
+ #define MTRACK_MAX_PROBE 8
+#endif
+
+// Maximum number of call sites in mtrack_sites() output.
+#ifndef MTRACK_SITES
+ #define MTRACK_SITES 32
+#endif
+
+// Maximum number of tasks resolved to names by print_mtrack().
+#ifndef MTRACK_TASKS
+ #define MTRACK_TASKS 16
+#endif
+
+/*
+ * Track all pvPortMalloc()/vPortFree() calls (link with
+ * -Wl,--wrap=pvPortMalloc,--wrap=vPortFree). Allocation goes to
+ * pool_malloc() if POOL_MALLOC == 1.
+ */
+#ifndef MTRACK_WRAP_MALLOC
+ #define MTRACK_WRAP_MALLOC 0
+#endif
+
+struct mtrack_site {
+	void *caller;
+	TaskHandle_t tsk;
+	int count;
+	int bytes;
+};
+
+struct mtrack_stats {
+	int live;
+	int peak;
+	unsigned int lost;
+	unsigned int unknown;
+	unsigned int probes;
+	unsigned int ops;
+	int max_probe;
+};
+
+/**
+ * mtrack_alloc
+ *
+ * Record allocation (caller, current task handle or NULL before scheduler
+ * start, size, sequence number). Handle is not dereferenced, it may be
+ * stale when table is printed. Needs xTaskGetSchedulerState()
+ * (INCLUDE_xTaskGetSchedulerState or configUSE_TIMERS). If no
+ * free slot is found within MTRACK_MAX_PROBE slots, allocation is not
+ * recorded (lost counter).
+ *
+ * @p: Allocated block (NULL is ignored).
+ * @size: Size of block.
+ * @caller: Call site (return address of allocation call).
+ */
+void mtrack_alloc(void *p, size_t size, void *caller);
+
+/**
+ * mtrack_free
+ *
+ * Remove record of block (unknown counter if not found).
+ */
+void mtrack_free(void *p);
+
+/**
+ * mtrack_mark
+ *
+ * Start snapshot diff. mtrack_sites(.., TRUE) then lists only allocations
+ * made after mark and still live (leak candidates).
+ */
+void mtrack_mark(void);
+
+/**
+ * mtrack_sites
+ *
+ * Group live allocations by call site and task, sorted by bytes
+ * (descending).
+ *
+ * @site: Output array.
+ * @n: Array size.
+ * @diff: TRUE - only allocations after mtrack_mark().
+ *
+ * Returns: Number of call sites (sites over n are merged to last entry
+ *   with caller NULL).
+ */
+int mtrack_sites(struct mtrack_site *site, int n, boolean_t diff);
+
+/**
+ * mtrack_get_stats
+ *
+ * Live and peak number of records, lost records, frees of unknown blocks,
+ * probe count, operation count and longest probe.
+ */
+void mtrack_get_stats(struct mtrack_stats *st);
+
+#if TERMOUT == 1
+/**
+ * print_mtrack
+ *
+ * Print live allocations grouped by call site (addresses are symbolized
+ * on host, e.g. addr2line -e app.elf) and statistics. Task handles are
+ * resolved to names by uxTaskGetSystemState() (configUSE_TRACE_FACILITY,
+ * up to MTRACK_TASKS tasks), handle of deleted task is printed as "?" and
+ * allocation made before scheduler start as "-".
+ *
+ * @diff: TRUE - only allocations after mtrack_mark().
+ */
+void print_mtrack(boolean_t diff);
+#endif
+
+#if defined(TERMCMD) && TERMCMD == 1
+/**
+ * mtrack_cmd
+ *
+ * Console command (register in init_tcmd() table): "mtrack" - all live
+ * allocations, "mtrack mark" - set mark, "mtrack diff" - allocations
+ * after mark.
+ */
+int mtrack_cmd(int argc, char **argv);
+#endif
+#endif
+
+#endif
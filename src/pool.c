@@ -0,0 +1,282 @@
+/*
+ * pool.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#include "fmalloc.h"
+#include "bitops.h"
+#include "pool.h"
+#include "mtrack.h"
+
+#if POOL == 1
+
+#if POOL_WRAP_MALLOC == 1 && POOL_MALLOC != 1
+ #error "POOL_WRAP_MALLOC requires POOL_MALLOC"
+#endif
+
+#if POOL_WRAP_MALLOC == 1 || (MTRACK == 1 && MTRACK_WRAP_MALLOC == 1)
+void *__real_pvPortMalloc(size_t size);
+void __real_vPortFree(void *p);
+ #define PORT_MALLOC(size) __real_pvPortMalloc(size)
+ #define PORT_FREE(p) __real_vPortFree(p)
+#else
+ #define PORT_MALLOC(size) pvPortMalloc(size)
+ #define PORT_FREE(p) vPortFree(p)
+#endif
+
+#if POOL_ISR_SAFE == 1
+ #define LOCK() UBaseType_t msk = taskENTER_CRITICAL_FROM_ISR()
+ #define UNLOCK() taskEXIT_CRITICAL_FROM_ISR(msk)
+#else
+ #define LOCK() taskENTER_CRITICAL()
+ #define UNLOCK() taskEXIT_CRITICAL()
+#endif
+
+#define ALGN(sz) (((sz) + POOL_ALIGN - 1) & ~(POOL_ALIGN - 1))
+#define CLS_N(sz, cnt) + 1
+#define CLS_ARENA(sz, cnt) + ALGN(sz) * (cnt)
+#define CLS_MAP(sz, cnt) + ALGN(sz) / POOL_ALIGN
+#define CLS_DEF(sz, cnt) {ALGN(sz), cnt},
+#define CLS_BMP(sz, cnt) + BMP_WORDS(cnt)
+#define CLS_BIG(sz, cnt) || ALGN(sz) > 0xFFFF || (cnt) > 0xFFFF
+
+#define NCLS (0 POOL_CLASSES(CLS_N))
+// Upper bound of largest class size / POOL_ALIGN (sum of all sizes).
+#define MAP_SZ (0 POOL_CLASSES(CLS_MAP))
+
+// Sizes and counts are uint16_t in def[] and cls, class index uint8_t in map[].
+#if 0 POOL_CLASSES(CLS_BIG)
+ #error "POOL_CLASSES size or count larger than 65535"
+#endif
+#if NCLS > 255
+ #error "POOL_CLASSES has more than 255 classes"
+#endif
+
+static const struct {
+	uint16_t sz;
+	uint16_t cnt;
+} def[NCLS] = {POOL_CLASSES(CLS_DEF)};
+
+static struct cls {
+	void *fre;
+	uint8_t *lo;
+	uint8_t *hi;
+	uint32_t *bmp;
+	uint16_t used;
+	uint16_t peak;
+	unsigned int fail;
+} cls[NCLS];
+
+static uint8_t arena[0 POOL_CLASSES(CLS_ARENA)] __attribute__((aligned(POOL_ALIGN)));
+// Class index for (size - 1) / POOL_ALIGN, NCLS - too large.
+static uint8_t map[MAP_SZ];
+// Allocated blocks, bit k is block k of class.
+static uint32_t bmp[0 POOL_CLASSES(CLS_BMP)];
+#if POOL_MALLOC == 1
+static boolean_t ini;
+#endif
+
+/**
+ * init_pool
+ */
+void init_pool(void)
+{
+	uint8_t *a = arena;
+	uint32_t *b = bmp;
+	int c = 0;
+
+	for (int i = 0; i < NCLS; i++) {
+		if (i && def[i].sz <= def[i - 1].sz) {
+			crit_err_exit(BAD_PARAMETER);
+		}
+		cls[i].lo = a;
+		cls[i].bmp = b;
+		cls[i].fre = NULL;
+		for (int k = def[i].cnt - 1; k >= 0; k--) {
+			*(void **) (a + k * def[i].sz) = cls[i].fre;
+			cls[i].fre = a + k * def[i].sz;
+		}
+		a += def[i].sz * def[i].cnt;
+		cls[i].hi = a;
+		b += BMP_WORDS(def[i].cnt);
+	}
+	for (int i = 0; i < MAP_SZ; i++) {
+		while (c < NCLS && def[c].sz < (i + 1) * POOL_ALIGN) {
+			c++;
+		}
+		map[i] = c;
+	}
+#if POOL_MALLOC == 1
+	ini = TRUE;
+#endif
+}
+
+/**
+ * pool_alloc
+ */
+void *pool_alloc(size_t size)
+{
+	struct cls *c;
+	void *p = NULL;
+	int i;
+
+	i = size ? (size - 1) / POOL_ALIGN : 0;
+	if (i >= MAP_SZ || map[i] == NCLS) {
+		return (NULL);
+	}
+	LOCK();
+	for (c = &cls[map[i]]; c < cls + NCLS; c++) {
+		if ((p = c->fre)) {
+			c->fre = *(void **) p;
+			bmp_set(c->bmp, ((uint8_t *) p - c->lo) / def[c - cls].sz);
+			if (++c->used > c->peak) {
+				c->peak = c->used;
+			}
+			break;
+		}
+		c->fail++;
+	}
+	UNLOCK();
+	return (p);
+}
+
+/**
+ * pool_free
+ */
+void pool_free(void *p)
+{
+	struct cls *c;
+	int sz, k;
+
+	if (p == NULL) {
+		return;
+	}
+	for (c = cls; c < cls + NCLS; c++) {
+		if ((uint8_t *) p >= c->lo && (uint8_t *) p < c->hi) {
+			break;
+		}
+	}
+	if (c == cls + NCLS) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	sz = def[c - cls].sz;
+	k = ((uint8_t *) p - c->lo) / sz;
+	if (c->lo + k * sz != p) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	LOCK();
+	if (!bmp_tst(c->bmp, k)) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	bmp_clr(c->bmp, k);
+	*(void **) p = c->fre;
+	c->fre = p;
+	c->used--;
+	UNLOCK();
+}
+
+/**
+ * pool_stats
+ */
+int pool_stats(struct pool_stat *st, int n)
+{
+	int i;
+
+	for (i = 0; i < n && i < NCLS; i++) {
+		LOCK();
+		st[i].used = cls[i].used;
+		st[i].peak = cls[i].peak;
+		st[i].fail = cls[i].fail;
+		UNLOCK();
+		st[i].size = def[i].sz;
+		st[i].count = def[i].cnt;
+	}
+	return (i);
+}
+
+#if POOL_MALLOC == 1
+/**
+ * pool_malloc
+ */
+void *pool_malloc(size_t size)
+{
+	void *p;
+
+	if (ini && size <= POOL_MALLOC_MAX && (p = pool_alloc(size))) {
+		return (p);
+	}
+	return (PORT_MALLOC(size));
+}
+
+/**
+ * pool_mfree
+ */
+void pool_mfree(void *p)
+{
+	if ((uint8_t *) p >= arena && (uint8_t *) p < arena + sizeof(arena)) {
+		pool_free(p);
+	} else {
+		PORT_FREE(p);
+	}
+}
+#endif
+
+#if POOL_WRAP_MALLOC == 1
+void *__wrap_pvPortMalloc(size_t size);
+void __wrap_vPortFree(void *p);
+
+/**
+ * __wrap_pvPortMalloc
+ */
+void *__wrap_pvPortMalloc(size_t size)
+{
+	return (pool_malloc(size));
+}
+
+/**
+ * __wrap_vPortFree
+ */
+void __wrap_vPortFree(void *p)
+{
+	pool_mfree(p);
+}
+#endif
+
+#if TERMOUT == 1
+/**
+ * print_pool_stats
+ */
+void print_pool_stats(void)
+{
+	struct pool_stat st[NCLS];
+	int n;
+
+	n = pool_stats(st, NCLS);
+	msg(INF, "size count  used  peak  fail\n");
+	for (int i = 0; i < n; i++) {
+		msg(INF, "%4d %5d %5d %5d %5u\n", st[i].size, st[i].count, st[i].used,
+		    st[i].peak, st[i].fail);
+	}
+}
+#endif
+#endif
@@ -0,0 +1,146 @@
+/*
+ * pool.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef POOL_H
+#define POOL_H
+
+#ifndef POOL
+ #define POOL 0
+#endif
+
+#if POOL == 1
+
+/*
+ * Size classes, X(size, count) in ascending size order. Every class has own
+ * static arena of count blocks (size rounded up to POOL_ALIGN) and bitmap
+ * of allocated blocks (count bits). Size and count are up to 65535, number
+ * of classes up to 255.
+ */
+#ifndef POOL_CLASSES
+ #define POOL_CLASSES(X) X(16, 32) X(32, 16) X(64, 8) X(128, 4)
+#endif
+
+#ifndef POOL_ALIGN
+ #define POOL_ALIGN portBYTE_ALIGNMENT
+#endif
+
+/*
+ * Lock by taskENTER_CRITICAL_FROM_ISR(), pool functions are callable from
+ * ISR (requires port where it is usable in task context too, e.g. ARM CM).
+ */
+#ifndef POOL_ISR_SAFE
+ #define POOL_ISR_SAFE 0
+#endif
+
+// pool_malloc() and pool_mfree() (pools for small requests, heap otherwise).
+#ifndef POOL_MALLOC
+ #define POOL_MALLOC 0
+#endif
+
+// Largest request served by pools in pool_malloc().
+#ifndef POOL_MALLOC_MAX
+ #define POOL_MALLOC_MAX 128
+#endif
+
+/*
+ * Route all pvPortMalloc()/vPortFree() calls through pool_malloc() and
+ * pool_mfree() (link with -Wl,--wrap=pvPortMalloc,--wrap=vPortFree).
+ */
+#ifndef POOL_WRAP_MALLOC
+ #define POOL_WRAP_MALLOC 0
+#endif
+
+struct pool_stat {
+	int size;
+	int count;
+	int used;
+	int peak;
+	unsigned int fail;
+};
+
+/**
+ * init_pool
+ *
+ * Build free lists of all classes.
+ */
+void init_pool(void);
+
+/**
+ * pool_alloc
+ *
+ * Allocate block from smallest class with size >= size, if class is empty
+ * next larger classes are tried (class fail counter is incremented). Time
+ * is O(1) (table lookup of class, free list pop).
+ *
+ * @size: Requested size.
+ *
+ * Returns: Pointer to block or NULL (too large or all fitting classes empty).
+ */
+void *pool_alloc(size_t size);
+
+/**
+ * pool_free
+ *
+ * Pointer outside of pools or not at block start and free of block which
+ * is not allocated (double free, per-class bitmap of allocated blocks)
+ * call crit_err_exit(BAD_PARAMETER). Time is O(1) except search of class
+ * by address (one comparison per class).
+ *
+ * @p: Block from pool_alloc() or NULL.
+ */
+void pool_free(void *p);
+
+/**
+ * pool_stats
+ *
+ * Copy per-class statistics (block size, blocks, used blocks, peak used
+ * blocks, number of requests which found class empty).
+ *
+ * @st: Output array.
+ * @n: Array size.
+ *
+ * Returns: Number of classes copied.
+ */
+int pool_stats(struct pool_stat *st, int n);
+
+#if POOL_MALLOC == 1
+/**
+ * pool_malloc
+ *
+ * Requests up to POOL_MALLOC_MAX bytes are served by pool_alloc(), larger
+ * requests and requests failed in pools by pvPortMalloc().
+ */
+void *pool_malloc(size_t size);
+
+/**
+ * pool_mfree
+ *
+ * Free block from pool_malloc() (arena address test decides where).
+ */
+void pool_mfree(void *p);
+#endif
+
+#if TERMOUT == 1
+/**
+ * print_pool_stats
+ */
+void print_pool_stats(void);
+#endif
+#endif
+
+#endif
@@ -0,0 +1,370 @@
+/*
+ * prof.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#include "tcmd.h"
+#include "prof.h"
+#include <stdio.h>
+#include <string.h>
+
+#if PROF == 1
+
+#if PROF_RING_SIZE & (PROF_RING_SIZE - 1) || PROF_HIST_SIZE & (PROF_HIST_SIZE - 1)
+ #error "PROF_RING_SIZE and PROF_HIST_SIZE must be power of 2"
+#endif
+
+#if TERMOUT == 1 && TERMOUT_MAX_ROW_LENGTH < 22
+ #error "TERMOUT_MAX_ROW_LENGTH too small for prof_dump()"
+#endif
+
+#ifndef PROF_GET_PC
+ #if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+  #define PROF_GET_PC() psp_pc()
+  #define PROF_RETTOBASE 1
+ #elif defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_8M_BASE__)
+  #define PROF_GET_PC() psp_pc()
+  #define PROF_RETTOBASE 0
+ #else
+  #error "PROF_GET_PC() must be defined for this architecture"
+ #endif
+#endif
+
+static const char *const tsk_nm = "PROF";
+static SemaphoreHandle_t mtx;
+
+static struct smp {
+	uint32_t pc;
+	TaskHandle_t tsk;
+} ring[PROF_RING_SIZE];
+static uint32_t head, tail;
+static volatile boolean_t run;
+static int div_cnt = PROF_DIV;
+static volatile unsigned int drop;
+
+// Bucket with cnt 0 is free.
+struct bkt {
+	uint32_t pc;
+	unsigned int cnt;
+};
+
+struct tsk_smp {
+	TaskHandle_t tsk;
+	unsigned int cnt;
+};
+
+static struct bkt hist[PROF_HIST_SIZE];
+static struct tsk_smp tsk_cnt[PROF_TASKS];
+static unsigned int smp_cnt, oth_cnt, oth_tsk;
+
+static void prof_tsk(void *p);
+static void drain(void);
+static void add_pc(uint32_t pc);
+static void add_tsk(TaskHandle_t tsk);
+#if TERMOUT == 1
+static const char *hndl_nm(TaskHandle_t t, const TaskStatus_t *ts, int n);
+static void dump_hist(const struct bkt *hs);
+#endif
+
+#ifdef PROF_RETTOBASE
+/**
+ * psp_pc
+ *
+ * Tasks run on process stack, exception entry stacks R0-R3, R12, LR, PC,
+ * xPSR there.
+ */
+static inline uint32_t psp_pc(void)
+{
+	uint32_t *psp;
+
+#if PROF_RETTOBASE == 1
+	// ICSR.RETTOBASE is 0 if hook interrupted other exception.
+	if (!(*(volatile uint32_t *) 0xE000ED04 & (1U << 11))) {
+		return (0);
+	}
+#endif
+	__asm volatile ("mrs %0, psp" : "=r" (psp));
+	return (psp[6]);
+}
+#endif
+
+/**
+ * init_prof
+ */
+void init_prof(void)
+{
+	mtx = xSemaphoreCreateMutex();
+	if (mtx == NULL) {
+		crit_err_exit(MALLOC_ERROR);
+	}
+	if (pdPASS != xTaskCreate(prof_tsk, tsk_nm, PROF_STACK_SIZE, NULL,
+				  PROF_TASK_PRIO, NULL)) {
+		crit_err_exit(MALLOC_ERROR);
+	}
+}
+
+/**
+ * prof_tick_hook
+ */
+void prof_tick_hook(void)
+{
+	uint32_t h;
+
+	if (!run || --div_cnt) {
+		return;
+	}
+	div_cnt = PROF_DIV;
+	h = head;
+	if (h - __atomic_load_n(&tail, __ATOMIC_ACQUIRE) >= PROF_RING_SIZE) {
+		drop++;
+		return;
+	}
+	ring[h & (PROF_RING_SIZE - 1)].pc = PROF_GET_PC();
+	ring[h & (PROF_RING_SIZE - 1)].tsk = xTaskGetCurrentTaskHandle();
+	__atomic_store_n(&head, h + 1, __ATOMIC_RELEASE);
+}
+
+/**
+ * prof_start
+ */
+void prof_start(void)
+{
+	run = TRUE;
+}
+
+/**
+ * prof_stop
+ */
+void prof_stop(void)
+{
+	run = FALSE;
+}
+
+/**
+ * prof_clear
+ */
+void prof_clear(void)
+{
+	xSemaphoreTake(mtx, portMAX_DELAY);
+	drain();
+	memset(hist, 0, sizeof(hist));
+	memset(tsk_cnt, 0, sizeof(tsk_cnt));
+	smp_cnt = oth_cnt = oth_tsk = drop = 0;
+	xSemaphoreGive(mtx);
+}
+
+/**
+ * prof_tsk
+ */
+static void prof_tsk(void *p)
+{
+	TickType_t tm = xTaskGetTickCount();
+
+	while (TRUE) {
+		vTaskDelayUntil(&tm, pdMS_TO_TICKS(PROF_PERIOD_MS));
+		xSemaphoreTake(mtx, portMAX_DELAY);
+		drain();
+		xSemaphoreGive(mtx);
+	}
+}
+
+/**
+ * drain
+ *
+ * Consumer side of sample ring (mutex must be held).
+ */
+static void drain(void)
+{
+	uint32_t t = tail, h = __atomic_load_n(&head, __ATOMIC_ACQUIRE);
+
+	for (; t != h; t++) {
+		add_pc(ring[t & (PROF_RING_SIZE - 1)].pc >> PROF_PC_SHIFT);
+		add_tsk(ring[t & (PROF_RING_SIZE - 1)].tsk);
+		smp_cnt++;
+	}
+	__atomic_store_n(&tail, t, __ATOMIC_RELEASE);
+}
+
+/**
+ * add_pc
+ */
+static void add_pc(uint32_t pc)
+{
+	uint32_t i = pc * 0x9E3779B1U;
+
+	i ^= i >> 16;
+	for (int k = 0; k < PROF_MAX_PROBE; k++, i++) {
+		i &= PROF_HIST_SIZE - 1;
+		if (hist[i].cnt == 0) {
+			hist[i].pc = pc;
+			hist[i].cnt = 1;
+			return;
+		}
+		if (hist[i].pc == pc) {
+			hist[i].cnt++;
+			return;
+		}
+	}
+	oth_cnt++;
+}
+
+/**
+ * add_tsk
+ *
+ * Handle is not dereferenced, name is resolved by prof_dump().
+ */
+static void add_tsk(TaskHandle_t tsk)
+{
+	int i;
+
+	for (i = 0; i < PROF_TASKS && tsk_cnt[i].cnt; i++) {
+		if (tsk_cnt[i].tsk == tsk) {
+			tsk_cnt[i].cnt++;
+			return;
+		}
+	}
+	if (i == PROF_TASKS) {
+		oth_tsk++;
+		return;
+	}
+	tsk_cnt[i].tsk = tsk;
+	tsk_cnt[i].cnt = 1;
+}
+
+#if TERMOUT == 1
+/**
+ * prof_dump
+ */
+void prof_dump(void)
+{
+	static struct bkt hs[PROF_HIST_SIZE];
+	static struct tsk_smp tc[PROF_TASKS];
+	static TaskStatus_t ts[PROF_TASKS];
+	static char nm[PROF_TASKS][configMAX_TASK_NAME_LEN];
+	unsigned int smp, drp, oth, oth_t;
+	int nt = 0;
+
+	xSemaphoreTake(mtx, portMAX_DELAY);
+	drain();
+	memcpy(hs, hist, sizeof(hs));
+	memcpy(tc, tsk_cnt, sizeof(tc));
+	smp = smp_cnt;
+	drp = drop;
+	oth = oth_cnt;
+	oth_t = oth_tsk;
+	xSemaphoreGive(mtx);
+#if configUSE_TRACE_FACILITY == 1
+	// Idle task may free TCB of deleted task with its name.
+	vTaskSuspendAll();
+	nt = uxTaskGetSystemState(ts, PROF_TASKS, NULL);
+	for (int i = 0; i < nt; i++) {
+		strncpy(nm[i], ts[i].pcTaskName, configMAX_TASK_NAME_LEN - 1);
+		nm[i][configMAX_TASK_NAME_LEN - 1] = '\0';
+		ts[i].pcTaskName = nm[i];
+	}
+	xTaskResumeAll();
+#endif
+	add_msg_tout_wait("prof: smp=%u drop=%u other=%u shift=%d\n", smp, drp, oth,
+	                  PROF_PC_SHIFT);
+	for (int i = 0; i < PROF_TASKS && tc[i].cnt; i++) {
+		add_msg_tout_wait("T %s %u\n", hndl_nm(tc[i].tsk, ts, nt), tc[i].cnt);
+	}
+	if (oth_t) {
+		add_msg_tout_wait("T ? %u\n", oth_t);
+	}
+	dump_hist(hs);
+	add_msg_tout_wait("prof: end\n");
+}
+
+/**
+ * dump_hist
+ *
+ * Line is flushed after PROF_DUMP_PER_LINE entries or before it would be
+ * truncated by TERMOUT_MAX_ROW_LENGTH (with '\n').
+ */
+static void dump_hist(const struct bkt *hs)
+{
+	char ln[TERMOUT_MAX_ROW_LENGTH], e[24];
+	int n = 0, len = 0, k;
+
+	for (int i = 0; i < PROF_HIST_SIZE; i++) {
+		if (hs[i].cnt == 0) {
+			continue;
+		}
+		k = snprintf(e, sizeof(e), " %08x:%u", (unsigned int) (hs[i].pc << PROF_PC_SHIFT),
+		             hs[i].cnt);
+		if (n == PROF_DUMP_PER_LINE || (n && len + k > TERMOUT_MAX_ROW_LENGTH - 1)) {
+			add_msg_tout_wait("%s\n", ln);
+			n = 0;
+		}
+		if (n == 0) {
+			ln[0] = 'P';
+			len = 1;
+		}
+		memcpy(ln + len, e, k + 1);
+		len += k;
+		n++;
+	}
+	if (n) {
+		add_msg_tout_wait("%s\n", ln);
+	}
+}
+
+/**
+ * hndl_nm
+ */
+static const char *hndl_nm(TaskHandle_t t, const TaskStatus_t *ts, int n)
+{
+	if (t == NULL) {
+		return ("-");
+	}
+	for (int i = 0; i < n; i++) {
+		if (ts[i].xHandle == t) {
+			return (ts[i].pcTaskName);
+		}
+	}
+	return ("?");
+}
+#endif
+
+#if defined(TERMCMD) && TERMCMD == 1
+/**
+ * prof_cmd
+ */
+int prof_cmd(int argc, char **argv)
+{
+	if (argc == 1) {
+		prof_dump();
+	} else if (argc == 2 && !strcmp(argv[1], "start")) {
+		prof_start();
+	} else if (argc == 2 && !strcmp(argv[1], "stop")) {
+		prof_stop();
+	} else if (argc == 2 && !strcmp(argv[1], "clear")) {
+		prof_clear();
+	} else {
+		return (1);
+	}
+	return (0);
+}
+#endif
+#endif
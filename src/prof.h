@@ -0,0 +1,149 @@
+/*
+ * prof.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef PROF_H
+#define PROF_H
+
+#ifndef PROF
+ #define PROF 0
+#endif
+
+#if PROF == 1
+
+// Sample ring size (power of 2).
+#ifndef PROF_RING_SIZE
+ #define PROF_RING_SIZE 64
+#endif
+
+// PC histogram size (power of 2).
+#ifndef PROF_HIST_SIZE
+ #define PROF_HIST_SIZE 256
+#endif
+
+// Maximum probe length in PC histogram (sample counted as other if full).
+#ifndef PROF_MAX_PROBE
+ #define PROF_MAX_PROBE 8
+#endif
+
+// PC bucket is PC >> PROF_PC_SHIFT (coarser buckets, fewer entries).
+#ifndef PROF_PC_SHIFT
+ #define PROF_PC_SHIFT 0
+#endif
+
+// Sample every PROF_DIV-th prof_tick_hook() call.
+#ifndef PROF_DIV
+ #define PROF_DIV 1
+#endif
+
+// Number of tasks with own sample counter.
+#ifndef PROF_TASKS
+ #define PROF_TASKS 16
+#endif
+
+// Aggregation task period.
+#ifndef PROF_PERIOD_MS
+ #define PROF_PERIOD_MS 50
+#endif
+
+#ifndef PROF_TASK_PRIO
+ #define PROF_TASK_PRIO (tskIDLE_PRIORITY + 1)
+#endif
+
+// PC histogram entries per dump line (up to 20 characters each, line is
+// flushed earlier if next entry does not fit in TERMOUT_MAX_ROW_LENGTH).
+#ifndef PROF_DUMP_PER_LINE
+ #define PROF_DUMP_PER_LINE 4
+#endif
+
+#define PROF_HOOK() prof_tick_hook()
+
+/**
+ * init_prof
+ *
+ * Create aggregation task (PROF_STACK_SIZE, PROF_TASK_PRIO). Task drains
+ * sample ring every PROF_PERIOD_MS to PC histogram and task counters.
+ */
+void init_prof(void);
+
+/**
+ * prof_tick_hook
+ *
+ * Take sample (interrupted PC, running task) to lock-free ring. Call from
+ * vApplicationTickHook() (configUSE_TICK_HOOK) or from spare timer ISR
+ * (sampling rate is its rate / PROF_DIV). PC is read by PROF_GET_PC(),
+ * default on ARM Cortex-M is PC from exception frame on process stack. On
+ * ARMv7-M and ARMv8-M mainline PC is 0 if hook interrupted other exception
+ * handler (ICSR.RETTOBASE). ARMv6-M and ARMv8-M baseline have no RETTOBASE,
+ * there sample taken in nested exception has PC of task which was running
+ * when outer handler was entered (handler time is charged to task code).
+ * If sampling is stopped, hook returns after one test.
+ */
+void prof_tick_hook(void);
+
+/**
+ * prof_start
+ */
+void prof_start(void);
+
+/**
+ * prof_stop
+ */
+void prof_stop(void);
+
+/**
+ * prof_clear
+ *
+ * Clear histogram, task counters and statistics.
+ */
+void prof_clear(void);
+
+#if TERMOUT == 1
+/**
+ * prof_dump
+ *
+ * Print results (waits for output, nothing is dropped). Results are
+ * copied under mutex and printed after it is released, so aggregation
+ * continues while output waits (call from one task at a time, copy is
+ * static):
+ *   "prof: smp=<samples> drop=<ring full> other=<histogram full> shift=<n>"
+ *   "T <task> <samples>" per task, name is resolved by
+ *   uxTaskGetSystemState() (configUSE_TRACE_FACILITY, up to PROF_TASKS
+ *   tasks, names are copied with scheduler suspended), "?" if task was
+ *   deleted
+ *   "P <pc>:<samples> ..." PROF_DUMP_PER_LINE histogram entries per line
+ *   "prof: end"
+ * PC is hexadecimal (bucket << PROF_PC_SHIFT), profsym.py symbolizes dump
+ * against ELF file.
+ */
+void prof_dump(void);
+#endif
+
+#if defined(TERMCMD) && TERMCMD == 1
+/**
+ * prof_cmd
+ *
+ * Console command (register in init_tcmd() table): "prof start",
+ * "prof stop", "prof clear", "prof" (dump).
+ */
+int prof_cmd(int argc, char **argv);
+#endif
+#else
+ #define PROF_HOOK()
+#endif
+
+#endif
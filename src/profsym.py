@@ -0,0 +1,70 @@
+#!/usr/bin/env python3
+#
+# profsym.py
+#
+# Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+#
+# Permission to use, copy, modify, and distribute this software for any
+# purpose with or without fee is hereby granted, provided that the above
+# copyright notice and this permission notice appear in all copies.
+#
+# THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+# WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+# MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+# ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+# WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+# ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+# OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+#
+# Symbolizes prof_dump() output (prof.c) against ELF file.
+# Usage: python3 profsym.py app.elf console.log [addr2line]
+
+import subprocess
+import sys
+
+
+def parse(f):
+    pcs, tsk, hdr = {}, [], None
+    for ln in f:
+        ln = ln.strip()
+        if ln.startswith("prof: smp="):
+            pcs, tsk, hdr = {}, [], ln
+        elif ln.startswith("T "):
+            nm, cnt = ln[2:].rsplit(" ", 1)
+            tsk.append((nm, int(cnt)))
+        elif ln.startswith("P "):
+            for e in ln[2:].split():
+                pc, cnt = e.split(":")
+                pcs[int(pc, 16)] = pcs.get(int(pc, 16), 0) + int(cnt)
+    return hdr, tsk, pcs
+
+
+def main():
+    if len(sys.argv) < 3:
+        sys.exit("usage: profsym.py app.elf console.log [addr2line]")
+    a2l = sys.argv[3] if len(sys.argv) > 3 else "arm-none-eabi-addr2line"
+    with open(sys.argv[2], errors="replace") as f:
+        hdr, tsk, pcs = parse(f)
+    if hdr is None:
+        sys.exit("no prof dump found")
+    adr = sorted(pcs)
+    out = []
+    # addr2line without addresses reads them from stdin.
+    if adr:
+        out = subprocess.run([a2l, "-f", "-e", sys.argv[1]] + ["%x" % a for a in adr],
+                             capture_output=True, text=True, check=True).stdout.split("\n")
+    fn = {}
+    for i, a in enumerate(adr):
+        nm = out[2 * i] if a else "(exception)"
+        fn[nm] = fn.get(nm, 0) + pcs[a]
+    # Samples dropped from full histogram are in smp, not in pcs.
+    tot = int(hdr.split()[1].split("=")[1]) or 1
+    print(hdr)
+    for nm, cnt in sorted(tsk, key=lambda t: -t[1]):
+        print("%6.2f%% %8d  task %s" % (100.0 * cnt / tot, cnt, nm))
+    for nm, cnt in sorted(fn.items(), key=lambda t: -t[1]):
+        print("%6.2f%% %8d  %s" % (100.0 * cnt / tot, cnt, nm))
+
+
+if __name__ == "__main__":
+    main()
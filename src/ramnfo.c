@@ -23,67 +23,308 @@
 #include <gentyp.h>
 #include "sysconf.h"
 #include "msgconf.h"
+#include "bitops.h"
 #include "ramnfo.h"
+#include <string.h>
 
-#if TERMOUT == 1
+#define MAIN_STACK_FILL 0xCC
+#define TASK_STACK_FILL 0xA5
 
 extern unsigned char __stack_start__, __stack_end__;
 extern unsigned char __stack_process_start__, __stack_process_end__;
 
-static int st_us(unsigned char *s_st, unsigned char *s_en);
+static int st_us(const unsigned char *lo, const unsigned char *hi, unsigned char fill);
+#if RAMNFO_TASK_STACKS == 1
+static void tsk_rd(void);
+#endif
+static void add_blk(struct heap_info *hi, int sz);
+static void heap_fin(struct heap_info *hi);
+
+#if RAMNFO_TASK_STACKS == 1
+static TaskStatus_t tsk_st[RAMNFO_MAX_TASKS];
+static TaskHandle_t tsk_h[RAMNFO_MAX_TASKS];
+static UBaseType_t tsk_n;
+static boolean_t tsk_ovf;
+#if RAMNFO_TASK_GEN == 1
+static boolean_t tsk_vld;
+static unsigned int tsk_gen;
+#endif
+#endif
+
+#if RAMNFO_TASK_GEN == 1
+volatile unsigned int ramnfo_tsk_gen;
+#endif
+
+#if RAMNFO_HEAP_GEN == 1
+volatile unsigned int ramnfo_heap_gen;
+#endif
 
 /**
- * print_stack_usage
+ * stack_list
  */
-void print_stack_usage(void)
+int stack_list(struct stack_nfo *nfo, int n)
+{
+	int k = 0;
+
+	if (k < n) {
+		strcpy(nfo[k].nm, "main");
+		nfo[k].tsk = NULL;
+		nfo[k].lo = &__stack_start__;
+		nfo[k].size = &__stack_end__ - &__stack_start__;
+		nfo[k++].fill = MAIN_STACK_FILL;
+	}
+	if (k < n) {
+		strcpy(nfo[k].nm, "proc");
+		nfo[k].tsk = NULL;
+		nfo[k].lo = &__stack_process_start__;
+		nfo[k].size = &__stack_process_end__ - &__stack_process_start__;
+		nfo[k++].fill = MAIN_STACK_FILL;
+	}
+#if RAMNFO_TASK_STACKS == 1
+	TaskStatus_t ts;
+
+	// Handle cache is shared, keep other callers out.
+	vTaskSuspendAll();
+#if RAMNFO_TASK_GEN == 1
+	if (!tsk_vld || tsk_gen != ramnfo_tsk_gen) {
+		tsk_gen = ramnfo_tsk_gen;
+		tsk_vld = TRUE;
+		tsk_rd();
+	}
+#else
+	tsk_rd();
+#endif
+	for (UBaseType_t i = 0; i < tsk_n && k < n; i++, k++) {
+		vTaskGetInfo(tsk_h[i], &ts, pdFALSE, eInvalid);
+		strncpy(nfo[k].nm, ts.pcTaskName, configMAX_TASK_NAME_LEN - 1);
+		nfo[k].nm[configMAX_TASK_NAME_LEN - 1] = '\0';
+		nfo[k].tsk = tsk_h[i];
+		nfo[k].lo = (unsigned char *) ts.pxStackBase;
+		nfo[k].size = (unsigned char *) (ts.pxEndOfStack + 1) - nfo[k].lo;
+		nfo[k].fill = TASK_STACK_FILL;
+	}
+	xTaskResumeAll();
+	if (tsk_ovf) {
+		return (-k);
+	}
+#endif
+	return (k);
+}
+
+#if RAMNFO_TASK_STACKS == 1
+/**
+ * tsk_rd
+ */
+static void tsk_rd(void)
 {
-        int us, sz;
+	// Zero only if array is too small, idle task always exists.
+	tsk_n = uxTaskGetSystemState(tsk_st, RAMNFO_MAX_TASKS, NULL);
+	tsk_ovf = tsk_n == 0;
+	for (UBaseType_t i = 0; i < tsk_n; i++) {
+		tsk_h[i] = tsk_st[i].xHandle;
+	}
+}
+#endif
 
-        us = st_us(&__stack_start__, &__stack_end__);
-        sz = &__stack_end__ - &__stack_start__;
-        msg(INF, "main_stack: size=%d used=%d\n", sz, us);
+/**
+ * stack_scan
+ */
+void stack_scan(struct stack_nfo *nfo)
+{
+	nfo->used = st_us(nfo->lo, nfo->lo + nfo->size, nfo->fill);
+	nfo->margin = nfo->size - nfo->used;
+}
 
-        us = st_us(&__stack_process_start__, &__stack_process_end__);
-        sz = &__stack_process_end__ - &__stack_process_start__;
-        msg(INF, "proc_stack: size=%d used=%d\n", sz, us);
+/**
+ * stack_usage
+ */
+int stack_usage(struct stack_nfo *nfo, int n)
+{
+	n = stack_list(nfo, n);
+	for (int i = 0; i < (n < 0 ? -n : n); i++) {
+		stack_scan(nfo + i);
+	}
+	return (n);
 }
 
 /**
  * st_us
  */
-static int st_us(unsigned char *s_st, unsigned char *s_en)
+static int st_us(const unsigned char *lo, const unsigned char *hi, unsigned char fill)
 {
-	int sz;
+	const uint32_t *w, *e;
+	uint32_t f = fill * 0x01010101U;
 
-        for (sz = s_en - s_st; sz > 0; sz--) {
-                if (*s_st++ != 0xCC) {
-                        break;
-                }
-        }
-        return (sz);
+	while (((uintptr_t) lo & 3) && lo < hi) {
+		if (*lo != fill) {
+			return (hi - lo);
+		}
+		lo++;
+	}
+	w = (const uint32_t *) lo;
+	e = (const uint32_t *) ((uintptr_t) hi & ~(uintptr_t) 3);
+#if RAMNFO_STACK_BSEARCH == 1
+	const uint32_t *m;
+
+	while (w < e) {
+		m = w + (e - w) / 2;
+		if (*m == f) {
+			w = m + 1;
+		} else {
+			e = m;
+		}
+	}
+#else
+	while (w < e && *w == f) {
+		w++;
+	}
+#endif
+	for (lo = (const unsigned char *) w; lo < hi; lo++) {
+		if (*lo != fill) {
+			break;
+		}
+	}
+	return (hi - lo);
 }
 
 extern unsigned char __heap_start__, __heap_end__;
 
+/**
+ * heap_info
+ */
+int heap_info(struct heap_info *hi, struct heap_blk *blk, int n, int max)
+{
+	unsigned int *p_h;
+	int k = 0, sz;
+
+	memset(hi, 0, sizeof(struct heap_info));
+	hi->size = &__heap_end__ - &__heap_start__;
+	vTaskSuspendAll();
+	p_h = (unsigned int *) &__heap_start__;
+	for (; p_h; p_h = (unsigned int *) (uintptr_t) *p_h) {
+		if ((sz = *(p_h + 1)) == 0) {
+			continue;
+		}
+		if (max && hi->count == max) {
+			hi->partial = TRUE;
+			break;
+		}
+		if (k < n) {
+			blk[k].adr = p_h;
+			blk[k++].size = sz;
+		}
+		add_blk(hi, sz);
+	}
+	xTaskResumeAll();
+	heap_fin(hi);
+	return (k);
+}
+
+#if RAMNFO_HEAP_GEN == 1
+/**
+ * heap_walk
+ */
+boolean_t heap_walk(struct heap_walk *w, int max)
+{
+	unsigned int *p_h;
+	int sz;
+
+	vTaskSuspendAll();
+	if (w->p == NULL || w->gen != ramnfo_heap_gen) {
+		memset(&w->hi, 0, sizeof(struct heap_info));
+		w->hi.size = &__heap_end__ - &__heap_start__;
+		w->gen = ramnfo_heap_gen;
+		p_h = (unsigned int *) &__heap_start__;
+	} else {
+		p_h = w->p;
+	}
+	for (; p_h && max > 0; p_h = (unsigned int *) (uintptr_t) *p_h, max--) {
+		if ((sz = *(p_h + 1)) != 0) {
+			add_blk(&w->hi, sz);
+		}
+	}
+	w->p = p_h;
+	xTaskResumeAll();
+	if (p_h) {
+		return (FALSE);
+	}
+	heap_fin(&w->hi);
+	return (TRUE);
+}
+#endif
+
+/**
+ * add_blk
+ */
+static void add_blk(struct heap_info *hi, int sz)
+{
+	int b;
+
+	hi->total += sz;
+	if (sz > hi->largest) {
+		hi->largest = sz;
+	}
+	hi->count++;
+	b = 27 - bit_clz(sz);
+	hi->hist[b < 0 ? 0 : b < RAMNFO_HEAP_BINS ? b : RAMNFO_HEAP_BINS - 1]++;
+}
+
+/**
+ * heap_fin
+ */
+static void heap_fin(struct heap_info *hi)
+{
+	if (hi->total) {
+		hi->frag = 100 - (int) (100ULL * hi->largest / hi->total);
+	}
+}
+
+#if TERMOUT == 1
+
+/**
+ * print_stack_usage
+ */
+void print_stack_usage(void)
+{
+	static struct stack_nfo nfo[RAMNFO_MAX_STACKS];
+	int n;
+
+	if ((n = stack_usage(nfo, RAMNFO_MAX_STACKS)) < 0) {
+		msg(INF, "more than %d tasks, task stacks not listed\n", RAMNFO_MAX_TASKS);
+		n = -n;
+	}
+	msg(INF, "stack              size   peak margin\n");
+	for (int i = 0; i < n; i++) {
+		msg(INF, "%-16.16s %6d %6d %6d\n", nfo[i].nm, nfo[i].size, nfo[i].used,
+		    nfo[i].margin);
+	}
+}
+
 /**
  * print_heap_usage
  */
 void print_heap_usage(void)
 {
-        int hs;
-        UBaseType_t prio;
-        unsigned int *p_h;
-
-        hs = &__heap_end__ - &__heap_start__;
-	prio = uxTaskPriorityGet(NULL);
-	vTaskPrioritySet(NULL, TASK_PRIO_HIGH);
-        p_h = (unsigned int *) &__heap_start__;
-        msg(INF, "heap size=%d\n", hs);
+	static struct heap_blk blk[RAMNFO_HEAP_SNAP];
+	struct heap_info hi;
+	int n;
+
+	n = heap_info(&hi, blk, RAMNFO_HEAP_SNAP, 0);
+	msg(INF, "heap size=%d free=%d largest=%d blocks=%d frag=%d%%\n", hi.size,
+	    hi.total, hi.largest, hi.count, hi.frag);
+	for (int i = 0; i < RAMNFO_HEAP_BINS; i++) {
+		if (i == RAMNFO_HEAP_BINS - 1) {
+			msg(INF, ">=%d: %d\n", 16 << i, hi.hist[i]);
+		} else {
+			msg(INF, "<%d: %d\n", 32 << i, hi.hist[i]);
+		}
+	}
 	msg(INF, "heap free blocks:\n");
-        while (p_h) {
-                msg(INF, "@%p size=%d\n", p_h, *(p_h + 1));
-                p_h = (unsigned int *) *p_h;
-        }
-        vTaskPrioritySet(NULL, prio);
+	for (int i = 0; i < n; i++) {
+		msg(INF, "@%p size=%d\n", blk[i].adr, blk[i].size);
+	}
+	if (hi.count > n) {
+		msg(INF, "(%d more)\n", hi.count - n);
+	}
 }
 #endif
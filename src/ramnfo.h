@@ -19,15 +19,190 @@
 #ifndef RAMNFO_H
 #define RAMNFO_H
 
+#ifndef RAMNFO_STACK_BSEARCH
+ #define RAMNFO_STACK_BSEARCH 0
+#endif
+
+#ifndef RAMNFO_MAX_TASKS
+ #define RAMNFO_MAX_TASKS 16
+#endif
+
+#if configUSE_TRACE_FACILITY == 1 && configRECORD_STACK_HIGH_ADDRESS == 1
+ #define RAMNFO_TASK_STACKS 1
+#else
+ #define RAMNFO_TASK_STACKS 0
+#endif
+
+/*
+ * Task list generation, counts task creates and deletes. Needs in C part of
+ * FreeRTOSConfig.h:
+ *   extern volatile unsigned int ramnfo_tsk_gen;
+ *   #define traceTASK_CREATE(t) ramnfo_tsk_gen++
+ *   #define traceTASK_DELETE(t) ramnfo_tsk_gen++
+ */
+#ifndef RAMNFO_TASK_GEN
+ #define RAMNFO_TASK_GEN 0
+#endif
+
+#if RAMNFO_TASK_GEN == 1
+extern volatile unsigned int ramnfo_tsk_gen;
+#endif
+
+// Number of stacks reported by stack_list().
+#if RAMNFO_TASK_STACKS == 1
+ #define RAMNFO_MAX_STACKS (2 + RAMNFO_MAX_TASKS)
+#else
+ #define RAMNFO_MAX_STACKS 2
+#endif
+
+struct stack_nfo {
+	char nm[configMAX_TASK_NAME_LEN];
+	TaskHandle_t tsk; // NULL for main and process stack.
+	unsigned char *lo;
+	int size;
+	int used;
+	int margin;
+	unsigned char fill;
+};
+
+/**
+ * stack_list
+ *
+ * Fill stack descriptors (name copy, task handle, lowest address, size,
+ * fill byte) of main stack, process stack and every task stack (if
+ * configUSE_TRACE_FACILITY and configRECORD_STACK_HIGH_ADDRESS are set).
+ * Stacks are not scanned (see stack_scan()). Task handles are read by
+ * uxTaskGetSystemState() (which scans every stack for high water mark),
+ * with RAMNFO_TASK_GEN == 1 only when task generation changes, and each
+ * task is then read by vTaskGetInfo() without stack scan. Scheduler is
+ * suspended meanwhile. Handles in descriptors are valid until task
+ * generation changes (or until scheduler is resumed if RAMNFO_TASK_GEN is
+ * 0).
+ *
+ * @nfo: Array of descriptors.
+ * @n: Array size (RAMNFO_MAX_STACKS is enough).
+ *
+ * Returns: Number of filled descriptors, negated if there are more than
+ *   RAMNFO_MAX_TASKS tasks (task stacks are then not listed).
+ */
+int stack_list(struct stack_nfo *nfo, int n);
+
+/**
+ * stack_scan
+ *
+ * Find peak use of one stack (fields used and margin). Painted region is
+ * scanned by 32-bit words from the lowest address (stacks grow down). With
+ * RAMNFO_STACK_BSEARCH == 1 painted region is binary searched, it is much
+ * faster for large stacks but peak use is underestimated if used part of
+ * stack contains never written word (e.g. uninitialized array).
+ *
+ * @nfo: Stack descriptor.
+ */
+void stack_scan(struct stack_nfo *nfo);
+
+/**
+ * stack_usage
+ *
+ * stack_list() and stack_scan() of every stack.
+ *
+ * Returns: Number of filled descriptors, negated as by stack_list().
+ */
+int stack_usage(struct stack_nfo *nfo, int n);
+
+// Free list snapshot size (blocks) used by print_heap_usage().
+#ifndef RAMNFO_HEAP_SNAP
+ #define RAMNFO_HEAP_SNAP 32
+#endif
+
+// Histogram bins: [0] < 32 B, [i] 16 << i .. (32 << i) - 1, last is open.
+#define RAMNFO_HEAP_BINS 8
+
+struct heap_blk {
+	void *adr;
+	int size;
+};
+
+struct heap_info {
+	int size;
+	int total;
+	int largest;
+	int count;
+	int frag;
+	int hist[RAMNFO_HEAP_BINS];
+	boolean_t partial; // Walk stopped after max blocks.
+};
+
+/**
+ * heap_info
+ *
+ * Walk heap free list. Scheduler is suspended only while list is walked
+ * (at most max blocks) and up to n blocks are copied to snapshot, derived
+ * values are computed afterwards. Values of partial walk cover only walked
+ * blocks.
+ *
+ * @hi: Heap size, total free, largest free block, number of free blocks,
+ *   fragmentation index (100 * (1 - largest / total), 0 - one block) and
+ *   histogram of free block sizes.
+ * @blk: Snapshot of free blocks (address, size) or NULL.
+ * @n: Snapshot size.
+ * @max: Maximum number of free blocks walked (0 - whole list).
+ *
+ * Returns: Number of blocks in snapshot.
+ */
+int heap_info(struct heap_info *hi, struct heap_blk *blk, int n, int max);
+
+/*
+ * Heap generation, counts allocations and frees. Needs in C part of
+ * FreeRTOSConfig.h (heap implementation must call hooks with scheduler
+ * suspended, as heap_4.c does):
+ *   extern volatile unsigned int ramnfo_heap_gen;
+ *   #define traceMALLOC(p, sz) ramnfo_heap_gen++
+ *   #define traceFREE(p, sz) ramnfo_heap_gen++
+ */
+#ifndef RAMNFO_HEAP_GEN
+ #define RAMNFO_HEAP_GEN 0
+#endif
+
+#if RAMNFO_HEAP_GEN == 1
+extern volatile unsigned int ramnfo_heap_gen;
+
+struct heap_walk {
+	struct heap_info hi;
+	unsigned int *p; // Next block, NULL - new walk.
+	unsigned int gen;
+};
+
+/**
+ * heap_walk
+ *
+ * Incremental heap_info() without snapshot. Every call walks at most max
+ * free list entries with scheduler suspended and continues where previous
+ * call stopped. Walk starts again if heap generation changed since its
+ * start.
+ *
+ * @w: Walk state (zeroed before first call).
+ * @max: Maximum number of entries walked by one call.
+ *
+ * Returns: TRUE - walk finished, w->hi holds values of whole list (next
+ *   call starts new walk).
+ */
+boolean_t heap_walk(struct heap_walk *w, int max);
+#endif
+
 #if TERMOUT == 1
 
 /**
  * print_stack_usage
+ *
+ * Print table of stacks (name, size, peak use, margin).
  */
 void print_stack_usage(void);
 
 /**
  * print_heap_usage
+ *
+ * Print heap_info() values and snapshot of first RAMNFO_HEAP_SNAP free
+ * blocks. Output is formatted after snapshot, at caller priority.
  */
 void print_heap_usage(void);
 #endif
@@ -0,0 +1,196 @@
+/*
+ * tcmd.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#include "tcmd.h"
+#include <string.h>
+
+#if TERMCMD == 1
+
+#if TERMOUT != 1
+ #error "tcmd.c depends on tout.c"
+#endif
+
+static const struct tcmd *cmd_tbl;
+static int cmd_n;
+static int str_sz;
+static int lkp_cnt, prb_cnt, prb_max, unkn_cnt;
+
+static int split_args(char *s, char **argv);
+static void prn_help(const char *nm);
+
+/**
+ * init_tcmd
+ */
+void init_tcmd(const struct tcmd *tbl, int n)
+{
+	str_sz = 0;
+	for (int i = 0; i < n; i++) {
+		if (i && strcmp((tbl + i - 1)->nm, (tbl + i)->nm) >= 0) {
+			crit_err_exit(BAD_PARAMETER);
+		}
+		str_sz += strlen((tbl + i)->nm) + 1;
+		if ((tbl + i)->hlp) {
+			str_sz += strlen((tbl + i)->hlp) + 1;
+		}
+	}
+	cmd_tbl = tbl;
+	cmd_n = n;
+}
+
+/**
+ * find_tcmd
+ */
+const struct tcmd *find_tcmd(const char *nm)
+{
+	int lo = 0, hi = cmd_n - 1, mid, cmp, prb = 0;
+	const struct tcmd *p = NULL;
+
+	while (lo <= hi) {
+		mid = (lo + hi) / 2;
+		prb++;
+		cmp = strcmp(nm, (cmd_tbl + mid)->nm);
+		if (cmp == 0) {
+			p = cmd_tbl + mid;
+			break;
+		} else if (cmp < 0) {
+			hi = mid - 1;
+		} else {
+			lo = mid + 1;
+		}
+	}
+	lkp_cnt++;
+	prb_cnt += prb;
+	if (prb > prb_max) {
+		prb_max = prb;
+	}
+	return (p);
+}
+
+/**
+ * tcmd_lp
+ */
+void tcmd_lp(char *s)
+{
+	char *argv[TERMCMD_MAX_ARGS + 1];
+	const struct tcmd *p;
+	int argc;
+
+	if (0 > (argc = split_args(s, argv))) {
+		add_msg_tout("too many arguments\n");
+		return;
+	}
+	if (argc == 0) {
+		return;
+	}
+	if (NULL == (p = find_tcmd(argv[0]))) {
+		if (!strcmp(argv[0], "help")) {
+			prn_help(argc > 1 ? argv[1] : NULL);
+		} else {
+			unkn_cnt++;
+			add_msg_tout("unknown command\n");
+		}
+		return;
+	}
+	if (0 != (*p->fn)(argc, argv)) {
+		if (p->hlp) {
+			add_msg_tout("%s %s\n", p->nm, p->hlp);
+		} else {
+			add_msg_tout("%s: bad arguments\n", p->nm);
+		}
+	}
+}
+
+/**
+ * split_args
+ *
+ * Arguments are separated by spaces. Argument may be enclosed in double
+ * quotes to include spaces. Separators are replaced by '\0' in place.
+ */
+static int split_args(char *s, char **argv)
+{
+	int argc = 0;
+
+	while (TRUE) {
+		while (*s == ' ' || *s == '\t') {
+			s++;
+		}
+		if (*s == '\0') {
+			break;
+		}
+		if (argc == TERMCMD_MAX_ARGS) {
+			return (-1);
+		}
+		if (*s == '"') {
+			argv[argc++] = ++s;
+			while (*s != '\0' && *s != '"') {
+				s++;
+			}
+		} else {
+			argv[argc++] = s;
+			while (*s != '\0' && *s != ' ' && *s != '\t') {
+				s++;
+			}
+		}
+		if (*s == '\0') {
+			break;
+		}
+		*s++ = '\0';
+	}
+	argv[argc] = NULL;
+	return (argc);
+}
+
+/**
+ * prn_help
+ */
+static void prn_help(const char *nm)
+{
+	const struct tcmd *p;
+
+	if (nm) {
+		if (NULL == (p = find_tcmd(nm))) {
+			add_msg_tout("unknown command\n");
+		} else {
+			add_msg_tout("%s %s\n", p->nm, p->hlp ? p->hlp : "");
+		}
+		return;
+	}
+	for (int i = 0; i < cmd_n; i++) {
+		p = cmd_tbl + i;
+		add_msg_tout("%s %s\n", p->nm, p->hlp ? p->hlp : "");
+	}
+}
+
+/**
+ * tcmd_stats
+ */
+void tcmd_stats(void)
+{
+	add_msg_tout("tcmd.c: cmds=%d tbl=%d str=%d lkp=%d prb=%d maxprb=%d unkn=%d\n",
+	             cmd_n, cmd_n * (int) sizeof(struct tcmd), str_sz, lkp_cnt,
+	             prb_cnt, prb_max, unkn_cnt);
+}
+#endif
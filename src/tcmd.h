@@ -0,0 +1,80 @@
+/*
+ * tcmd.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TCMD_H
+#define TCMD_H
+
+#ifndef TERMCMD
+ #define TERMCMD 0
+#endif
+
+#if TERMCMD == 1
+
+#ifndef TERMCMD_MAX_ARGS
+ #define TERMCMD_MAX_ARGS 8
+#endif
+
+struct tcmd {
+	const char *nm;
+	int (*fn)(int argc, char **argv);
+	const char *hlp;
+};
+
+/**
+ * init_tcmd
+ *
+ * Register console command table. Table is normally declared as static const
+ * array (placed in flash). Commands are found by binary search, so table
+ * must be sorted by name in strcmp() order and names must be unique.
+ * Unsorted table causes crit_err_exit(BAD_PARAMETER).
+ *
+ * @tbl: Pointer to command table.
+ * @n: Number of commands in table.
+ */
+void init_tcmd(const struct tcmd *tbl, int n);
+
+/**
+ * tcmd_lp
+ *
+ * Line processing function for init_tin(). Splits line to arguments
+ * (in place, without allocation) and runs command. If command function
+ * returns non zero value, help text of command is printed. Command "help"
+ * is built in (if table does not define it).
+ *
+ * @s: Pointer to line (modified).
+ */
+void tcmd_lp(char *s);
+
+/**
+ * find_tcmd
+ *
+ * Find command by name.
+ *
+ * @nm: Command name.
+ *
+ * Returns: Pointer to command or NULL.
+ */
+const struct tcmd *find_tcmd(const char *nm);
+
+/**
+ * tcmd_stats
+ */
+void tcmd_stats(void);
+#endif
+
+#endif
@@ -27,6 +27,8 @@
 #if defined(TERMIN_SLEEP) && TERMIN_SLEEP == 1
 #include "sleep.h"
 #include "hwerr.h"
+#elif defined(TERMIO) && TERMIO == 1
+#include "hwerr.h"
 #endif
 #include "tin.h"
 #include <string.h>
@@ -37,12 +39,24 @@
  #error "tin.c depends on tou.c"
 #endif
 
+#if TERMIO == 1
+#if TERMIN_SLEEP == 1 || TERMOUT_SLEEP == 1
+ #error "TERMIO not supported with TERMIN_SLEEP or TERMOUT_SLEEP"
+#endif
+#define TIO_EV_RX 0x01U
+#define TIO_EV_TX 0x02U
+#endif
+
 static char buff[TERMIN_MAX_ROW_LENGTH + 1];
 static int pos;
 static uint8_t c[] = " ";
 
 static TaskHandle_t tsk_hndl;
+#if TERMIO == 1
+static const char *const tsk_nm = "TIO";
+#else
 static const char *const tsk_nm = "TIN";
+#endif
 static boolean_t rcve;
 #if TERMIN_START_ECHO_ON == 1
 static boolean_t echo = TRUE;
@@ -55,8 +69,18 @@ static int (*rfn)(void *, void *, TickType_t);
 static boolean_t (*intr)(void *);
 #endif
 static void (*lp)(char *);
+#if TERMIN_STATS == 1
+static unsigned int byte_cnt, line_cnt, serr_cnt, lat_last, lat_max, byte_max;
+static unsigned long long busy;
+#endif
 
+#if TERMIO == 1
+static void tio_tsk(void *p);
+static boolean_t rcv_poll(void);
+#else
 static void tin_tsk(void *p);
+#endif
+static void rcv_byte(void);
 static void parse_byte(void);
 #if TERMIN_SLEEP == 1
 static void sleep_clbk(enum sleep_cmd cmd, ...);
@@ -81,15 +105,86 @@ void init_tin(int (*p_rcv_fn)(void *, void *, TickType_t),
 	rfn = p_rcv_fn;
 #endif
 	lp = lp_fn;
+#ifdef TERMIN_STATS_DWT
+	// DEMCR.TRCENA, DWT_CTRL.CYCCNTENA.
+	*(volatile uint32_t *) 0xE000EDFC |= 1U << 24;
+	*(volatile uint32_t *) 0xE0001000 |= 1U;
+#endif
+#if TERMIO == 1
+        if (pdPASS != xTaskCreate(tio_tsk, tsk_nm, TERMIO_STACK_SIZE, NULL,
+				  TERMIO_TASK_PRIO, &tsk_hndl)) {
+                crit_err_exit(MALLOC_ERROR);
+        }
+#else
         if (pdPASS != xTaskCreate(tin_tsk, tsk_nm, TERMIN_STACK_SIZE, NULL,
 				  TERMIN_TASK_PRIO, &tsk_hndl)) {
                 crit_err_exit(MALLOC_ERROR);
         }
+#endif
 #if TERMIN_SLEEP == 1
 	reg_sleep_clbk(sleep_clbk, SLEEP_PRIO_SUSP_FIRST);
 #endif
 }
 
+#if TERMIO == 1
+/**
+ * tio_tsk
+ *
+ * Input parser and output drain share one task. Task sleeps on notification
+ * (TIO_EV_RX set by tin_rx_notify(), TIO_EV_TX set by tout.c for every new
+ * record) and then alternates between received bytes and output records
+ * until both sides are idle.
+ */
+static void tio_tsk(void *p)
+{
+	boolean_t rx, tx;
+
+	tout_io_attach(xTaskGetCurrentTaskHandle(), TIO_EV_TX);
+	msg(INF, "tin.c: row=%d\n", TERMIN_MAX_ROW_LENGTH);
+	while (TRUE) {
+		do {
+			rx = rcv_poll();
+			tx = tout_io_drain();
+		} while (rx || tx);
+		xTaskNotifyWait(0, TIO_EV_RX | TIO_EV_TX, NULL, portMAX_DELAY);
+	}
+}
+
+/**
+ * rcv_poll
+ */
+static boolean_t rcv_poll(void)
+{
+	int ret, n = 0;
+
+	while (0 == (ret = (*rfn)(idv, c, 0))) {
+		rcv_byte();
+		if (++n == TERMIO_RX_BURST) {
+			return (TRUE);
+		}
+	}
+	if (ret != TERMIO_RFN_EMPTY) {
+		rcve = TRUE;
+	}
+	return (n ? TRUE : FALSE);
+}
+
+/**
+ * tin_rx_notify
+ */
+void tin_rx_notify(void)
+{
+	xTaskNotify(tsk_hndl, TIO_EV_RX, eSetBits);
+}
+
+/**
+ * tin_rx_notify_isr
+ */
+void tin_rx_notify_isr(BaseType_t *p_woken)
+{
+	xTaskNotifyFromISR(tsk_hndl, TIO_EV_RX, eSetBits, p_woken);
+}
+#else
 /**
  * tin_tsk
  */
@@ -103,27 +198,7 @@ static void tin_tsk(void *p)
 #else
 		if (0 == (*rfn)(idv, c, portMAX_DELAY)) {
 #endif
-			if (*c == '\r') {
-				if (!rcve) {
-					if (echo) {
-						add_msg_tout("\n");
-					}
-					if (lp) {
-						(*lp)(buff);
-					}
-				} else {
-					if (echo) {
-						add_msg_tout("\r\nserial line error\n");
-					} else {
-						add_msg_tout("serial line error\n");
-					}
-					rcve = FALSE;
-				}
-				pos = 0;
-				memset(buff, 0, TERMIN_MAX_ROW_LENGTH);
-				continue;
-			}
-			parse_byte();
+			rcv_byte();
 		} else {
 #if TERMIN_SLEEP == 1
 			if (ret == -EINTR) {
@@ -141,6 +216,58 @@ static void tin_tsk(void *p)
 		}
 	}
 }
+#endif
+
+/**
+ * rcv_byte
+ */
+static void rcv_byte(void)
+{
+#if TERMIN_STATS == 1
+	unsigned int t0 = TERMIN_STATS_CNT(), t;
+	byte_cnt++;
+#endif
+	if (*c == '\r') {
+		if (!rcve) {
+			if (echo) {
+				add_msg_tout("\n");
+			}
+#if TERMIN_STATS == 1
+			t = TERMIN_STATS_CNT() - t0;
+			lat_last = t;
+			if (t > lat_max) {
+				lat_max = t;
+			}
+			busy += t;
+			line_cnt++;
+#endif
+			if (lp) {
+				(*lp)(buff);
+			}
+		} else {
+#if TERMIN_STATS == 1
+			serr_cnt++;
+#endif
+			if (echo) {
+				add_msg_tout("\r\nserial line error\n");
+			} else {
+				add_msg_tout("serial line error\n");
+			}
+			rcve = FALSE;
+		}
+		pos = 0;
+		memset(buff, 0, TERMIN_MAX_ROW_LENGTH);
+		return;
+	}
+	parse_byte();
+#if TERMIN_STATS == 1
+	t = TERMIN_STATS_CNT() - t0;
+	if (t > byte_max) {
+		byte_max = t;
+	}
+	busy += t;
+#endif
+}
 
 /**
  * parse_byte
@@ -216,6 +343,25 @@ static void parse_byte(void)
 	}
 }
 
+#if TERMIN_STATS == 1
+/**
+ * tin_stats
+ */
+void tin_stats(void)
+{
+	unsigned int avg = 0, rate = 0;
+
+	if (byte_cnt) {
+		avg = busy / byte_cnt;
+	}
+	if (busy) {
+		rate = byte_cnt * 1000ULL / busy;
+	}
+	add_msg_tout("tin.c: bytes=%u lines=%u serr=%u lat=%u/%u byte=%u/%u rate=%u\n",
+	             byte_cnt, line_cnt, serr_cnt, lat_last, lat_max, avg, byte_max, rate);
+}
+#endif
+
 #if TERMIN_SLEEP == 1
 /**
  * sleep_clbk
@@ -29,6 +29,35 @@
  #define TERMIN_SLEEP 0
 #endif
 
+#ifndef TERMIN_STATS
+ #define TERMIN_STATS 0
+#endif
+
+#ifndef TERMIO
+ #define TERMIO 0
+#endif
+
+#if TERMIO == 1
+#ifndef TERMIO_RX_BURST
+ #define TERMIO_RX_BURST 16
+#endif
+#ifndef TERMIO_RFN_EMPTY
+ #define TERMIO_RFN_EMPTY (-ETIME)
+#endif
+#endif
+
+#if TERMIN_STATS == 1
+#ifndef TERMIN_STATS_CNT
+ #if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__) || defined(__ARM_ARCH_8M_MAIN__)
+  // DWT CYCCNT, enabled by init_tin().
+  #define TERMIN_STATS_CNT() (*(volatile uint32_t *) 0xE0001004)
+  #define TERMIN_STATS_DWT 1
+ #else
+  #error "TERMIN_STATS_CNT() cycle counter must be defined for this architecture"
+ #endif
+#endif
+#endif
+
 #if TERMIN_SLEEP == 1
 struct tin_idev {
 	void *p_idev;
@@ -47,6 +76,42 @@ void init_tin(int (*p_rcv_fn)(void *, void *, TickType_t), void *p_idev,
               void (*lp_fn)(char *));
 #endif
 
+#if TERMIO == 1
+/**
+ * tin_rx_notify
+ *
+ * Single console task mode (TERMIO). Wakes console task to read received
+ * bytes. Receive function passed to init_tin() is called with zero timeout
+ * and must return TERMIO_RFN_EMPTY (-ETIME by default) if no byte is
+ * available, other non zero value is reported as serial line error.
+ */
+void tin_rx_notify(void);
+
+/**
+ * tin_rx_notify_isr
+ *
+ * ISR variant of tin_rx_notify().
+ *
+ * @p_woken: Pointer to higher priority task woken flag.
+ */
+void tin_rx_notify_isr(BaseType_t *p_woken);
+#endif
+
+#if TERMIN_STATS == 1
+/**
+ * tin_stats
+ *
+ * Print input statistics. Times are in TERMIN_STATS_CNT() units (DWT cycle
+ * counter on ARMv7-M and ARMv8-M mainline).
+ *   bytes: received bytes.
+ *   lines: lines delivered to lp callback.
+ *   lat: last/max time from received '\r' to lp callback.
+ *   byte: average/max processing time of one byte (parse and echo).
+ *   rate: bytes processed per 1000 counts of busy time (sustainable rate).
+ */
+void tin_stats(void);
+#endif
+
 #endif
 
 #endif
@@ -24,8 +24,20 @@
 #include "sysconf.h"
 #include "criterr.h"
 #include "tools.h"
+#include "bitops.h"
 #include <string.h>
 
+static const char bv_nib[16][4] = {
+	{'0', '0', '0', '0'}, {'0', '0', '0', '1'}, {'0', '0', '1', '0'}, {'0', '0', '1', '1'},
+	{'0', '1', '0', '0'}, {'0', '1', '0', '1'}, {'0', '1', '1', '0'}, {'0', '1', '1', '1'},
+	{'1', '0', '0', '0'}, {'1', '0', '0', '1'}, {'1', '0', '1', '0'}, {'1', '0', '1', '1'},
+	{'1', '1', '0', '0'}, {'1', '1', '0', '1'}, {'1', '1', '1', '0'}, {'1', '1', '1', '1'}
+};
+
+static inline int clz64(uint64_t v);
+static uint64_t mul128(uint64_t a, uint64_t b, uint64_t *lo);
+static uint64_t div128(uint64_t hi, uint64_t lo, uint64_t d, uint64_t *rem);
+
 /**
  * find_txt_item
  */
@@ -42,6 +54,52 @@ const char *find_txt_item(int val, const struct txt_item *ary, const char *nf)
 	return (nf);
 }
 
+/**
+ * find_txt
+ */
+const char *find_txt(const struct txt_tbl *tbl, int val, const char *nf)
+{
+	if (tbl->type == TXT_TBL_DIRECT) {
+		unsigned int i = (unsigned int) val - (unsigned int) tbl->base;
+
+		if (i < (unsigned int) tbl->n && *(tbl->str + i)) {
+			return (*(tbl->str + i));
+		}
+		return (nf);
+	} else {
+		int lo = 0, hi = tbl->n - 1, mid;
+
+		while (lo <= hi) {
+			mid = (lo + hi) / 2;
+			if ((tbl->item + mid)->idx == val) {
+				return ((tbl->item + mid)->str);
+			} else if ((tbl->item + mid)->idx < val) {
+				lo = mid + 1;
+			} else {
+				hi = mid - 1;
+			}
+		}
+		return (nf);
+	}
+}
+
+#if TOOLS_TXT_TBL_CHECK == 1
+/**
+ * check_txt_tbl
+ */
+void check_txt_tbl(const struct txt_tbl *tbl)
+{
+	if (tbl->type != TXT_TBL_SORTED) {
+		return;
+	}
+	for (int i = 1; i < tbl->n; i++) {
+		if ((tbl->item + i - 1)->idx >= (tbl->item + i)->idx) {
+			crit_err_exit(BAD_PARAMETER);
+		}
+	}
+}
+#endif
+
 /**
  * prn_bv_pos
  */
@@ -75,48 +133,92 @@ void prn_bv_pos(char *s, unsigned int n, int sz, int msb)
  */
 void prn_bv_str(char *s, unsigned int n, int sz)
 {
-	unsigned int m = 1 << (sz - 1);
+	prn_bv64(s, n, sz, 4);
+}
 
-	for (int i = sz; i > 0; i--) {
-		if (i != sz && !(i % 4)) {
-			*s++ = ' ';
+/**
+ * conv_bv_sz
+ */
+boolean_t conv_bv_sz(const char *s, unsigned int *n, int sz)
+{
+	uint64_t v;
+
+	if (sz > (int) sizeof(unsigned int) * 8 || !conv_bv64(s, &v, sz)) {
+		return (FALSE);
+	}
+	*n = v;
+	return (TRUE);
+}
+
+/**
+ * prn_bv64
+ */
+int prn_bv64(char *s, uint64_t n, int sz, int grp)
+{
+	char t[64];
+	const char *p;
+	char *d = s;
+	int g;
+
+	if (grp <= 0 || grp >= sz || grp == 4) {
+		// Nibble aligned output, 4 characters per lookup.
+		g = sz % 4 ? sz % 4 : 4;
+		p = bv_nib[(n >> (sz - g)) & 0x0F] + 4 - g;
+		while (g--) {
+			*d++ = *p++;
 		}
-		if (n & m) {
-			*s++ = '1';
-		} else {
-			*s++ = '0';
+		for (int i = (sz - 1) / 4 * 4 - 4; i >= 0; i -= 4) {
+			if (grp == 4 && grp < sz) {
+				*d++ = ' ';
+			}
+			memcpy(d, bv_nib[(n >> i) & 0x0F], 4);
+			d += 4;
+		}
+	} else {
+		// Render to temporary buffer (right aligned), then copy groups.
+		for (int i = 0; i < sz; i += 4) {
+			memcpy(t + 60 - i, bv_nib[(n >> i) & 0x0F], 4);
 		}
-		if (i == 1) {
-			*s++ = '\0';
+		p = t + 64 - sz;
+		g = sz % grp ? sz % grp : grp;
+		memcpy(d, p, g);
+		d += g;
+		p += g;
+		for (int i = g; i < sz; i += grp) {
+			*d++ = ' ';
+			memcpy(d, p, grp);
+			d += grp;
+			p += grp;
 		}
-		n <<= 1;
 	}
+	*d = '\0';
+	return (d - s);
 }
 
 /**
- * conv_bv_sz
+ * conv_bv64
  */
-boolean_t conv_bv_sz(const char *s, unsigned int *n, int sz)
+boolean_t conv_bv64(const char *s, uint64_t *n, int sz)
 {
+	uint64_t v = 0;
 	int bsz = 0;
 
-        *n = 0;
-	for (int i = 0; i < (int) strlen(s); i++) {
-		if (*(s + i) == '0' || *(s + i) == '1') {
-			*n <<= 1;
-			if (*(s + i) == '1') {
-				*n |= 1;
+	for (; *s; s++) {
+		unsigned int c = *s - '0';
+
+		if (c <= 1) {
+			if (++bsz > 64) {
+				return (FALSE);
 			}
-			bsz++;
-		} else if (*(s + i) == ' ') {
-			continue;
-		} else {
+			v = (v << 1) | c;
+		} else if (*s != ' ') {
 			return (FALSE);
 		}
 	}
 	if (bsz != sz) {
 		return (FALSE);
 	}
+	*n = v;
 	return (TRUE);
 }
 
@@ -137,387 +239,817 @@ int num_diff(int n1, int n2)
  */
 int bit_pos(unsigned int bmp)
 {
-	unsigned int cmp = 0x01;
-	int pos = 0;
+	return (bit_ctz(bmp));
+}
 
-	for (; pos < (int) sizeof(unsigned int) * 8; pos++) {
-		if (bmp & cmp) {
-			break;
-		} else {
-			cmp <<= 1;
+/**
+ * long_division
+ */
+unsigned long long long_division(unsigned long long n, unsigned long long d)
+{
+	return (udiv64(n, d, NULL));
+}
+
+/**
+ * udiv64
+ */
+uint64_t udiv64(uint64_t n, uint64_t d, uint64_t *rem)
+{
+	uint64_t q = 0, r;
+	int sh;
+
+	if (!d) {
+		// Same result as previous long_division().
+		if (rem) {
+			*rem = n;
 		}
+		return (~(uint64_t) 0);
 	}
-	return (pos);
+	if (!((n | d) >> 32)) {
+		// Native 32-bit divider.
+		q = (uint32_t) n / (uint32_t) d;
+		r = (uint32_t) n - (uint32_t) q * (uint32_t) d;
+	} else if (d > n) {
+		r = n;
+	} else if (!(d >> 16)) {
+		// Four 32/16 steps, partial remainder is always < d.
+		uint32_t t, x = 0;
+
+		for (int i = 48; i >= 0; i -= 16) {
+			t = (x << 16) | (uint16_t) (n >> i);
+			x = t / (uint32_t) d;
+			q |= (uint64_t) x << i;
+			x = t - x * (uint32_t) d;
+		}
+		r = x;
+	} else {
+		// Shift-subtract from highest quotient bit only.
+		sh = clz64(d) - clz64(n);
+		d <<= sh;
+		r = n;
+		for (int i = sh; i >= 0; i--) {
+			uint64_t t = r >= d;
+
+			// Branchless step (quotient bits are unpredictable).
+			r -= d & -t;
+			q = (q << 1) | t;
+			d >>= 1;
+		}
+	}
+	if (rem) {
+		*rem = r;
+	}
+	return (q);
 }
 
 /**
- * long_division
+ * init_udiv64_rcp
  */
-unsigned long long long_division(unsigned long long n, unsigned long long d)
+void init_udiv64_rcp(struct udiv64_rcp *rc, uint64_t d)
 {
-	unsigned long long q = 0, r = 0, bit;
+	int l;
+	uint64_t m, r, e;
 
-	for (int i = 63; i >= 0; i--) {
-		bit = (unsigned long long) 1 << i;
-		r = r << 1;
-		if (n & bit) {
-			r |= 0x01;
+	if (!d) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	l = 63 - clz64(d);
+	rc->d = d;
+	if (!(d & (d - 1))) {
+		// Power of two, shift only.
+		rc->m = 0;
+		rc->sh = l;
+		rc->add = FALSE;
+		return;
+	}
+	// m = 2^(64 + l) / d, r = 2^(64 + l) % d (128/64 bit division).
+	m = div128(1ULL << l, 0, d, &r);
+	e = d - r;
+	if (e < 1ULL << l) {
+		rc->add = FALSE;
+	} else {
+		// Multiplier needs 65 bits, use add indicator.
+		m += m;
+		if (r + r >= d || r + r < r) {
+			m++;
 		}
-		if (r >= d) {
-			r = r - d;
-			q |= bit;
+		rc->add = TRUE;
+	}
+	rc->m = m + 1;
+	rc->sh = l;
+}
+
+/**
+ * udiv64_rcp
+ */
+uint64_t udiv64_rcp(const struct udiv64_rcp *rc, uint64_t n, uint64_t *rem)
+{
+	uint64_t q, lo;
+
+	if (!rc->m) {
+		q = n >> rc->sh;
+	} else {
+		q = mul128(rc->m, n, &lo);
+		if (rc->add) {
+			q = (((n - q) >> 1) + q) >> rc->sh;
+		} else {
+			q >>= rc->sh;
 		}
 	}
-	return q;
+	if (rem) {
+		*rem = n - q * rc->d;
+	}
+	return (q);
+}
+
+/**
+ * muldiv64
+ */
+boolean_t muldiv64(uint64_t a, uint64_t b, uint64_t c, uint64_t *q, uint64_t *rem)
+{
+	uint64_t hi, lo, r;
+
+	hi = mul128(a, b, &lo);
+	if (hi >= c) {
+		// Division by zero or quotient does not fit to 64 bits.
+		return (FALSE);
+	}
+	if (!hi) {
+		*q = udiv64(lo, c, &r);
+	} else {
+		*q = div128(hi, lo, c, &r);
+	}
+	if (rem) {
+		*rem = r;
+	}
+	return (TRUE);
+}
+
+/**
+ * clz64
+ */
+static inline int clz64(uint64_t v)
+{
+	return (v >> 32 ? bit_clz(v >> 32) : 32 + bit_clz(v));
+}
+
+/**
+ * mul128
+ *
+ * Returns: High 64 bits of a * b (low 64 bits to *lo).
+ */
+static uint64_t mul128(uint64_t a, uint64_t b, uint64_t *lo)
+{
+#if defined(__SIZEOF_INT128__)
+	unsigned __int128 p = (unsigned __int128) a * b;
+
+	*lo = p;
+	return (p >> 64);
+#else
+	uint64_t p00, p01, p10, p11, mid;
+
+	p00 = (uint64_t) (uint32_t) a * (uint32_t) b;
+	p01 = (uint64_t) (uint32_t) a * (b >> 32);
+	p10 = (a >> 32) * (uint32_t) b;
+	p11 = (a >> 32) * (b >> 32);
+	mid = (p00 >> 32) + (uint32_t) p01 + (uint32_t) p10;
+	*lo = (mid << 32) | (uint32_t) p00;
+	return (p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32));
+#endif
 }
 
+/**
+ * div128
+ *
+ * (hi:lo) / d, hi must be < d.
+ */
+static uint64_t div128(uint64_t hi, uint64_t lo, uint64_t d, uint64_t *rem)
+{
+	uint64_t q = 0, c;
+
+	for (int i = 63; i >= 0; i--) {
+		c = hi >> 63;
+		hi = (hi << 1) | (lo >> 63);
+		lo <<= 1;
+		c |= hi >= d;
+		hi -= d & -c;
+		q = (q << 1) | c;
+	}
+	*rem = hi;
+	return (q);
+}
+
+#define BITS_EXT (TOOLS_EXTRACT_BITS == 1 || TOOLS_EXTRACT_BITS_LE == 1)
+#define BITS_INS (TOOLS_INSERT_BITS == 1 || TOOLS_INSERT_BITS_LE == 1)
+#define BITS_WORD ((TOOLS_EXTRACT_BITS == 1 || TOOLS_INSERT_BITS == 1) &&\
+                   __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+
+#if BITS_EXT
+static void ext_bytes(const uint8_t *in, int lim, uint8_t *out, int osz, int start, int len);
+static uint64_t ld_win(const uint8_t *in, int lim, int pos, int nb);
+#endif
+#if BITS_INS
+static void ins_bytes(uint8_t *out, const uint8_t *in, int isz, int start, int len);
+#endif
+#if BITS_EXT || BITS_INS || TOOLS_BITS_SCHEMA == 1
+static void st_win(uint8_t *out, uint64_t v, int n);
+static uint64_t ld_bytes(const uint8_t *p, int m);
+static inline uint64_t ld_le(const uint8_t *p, int n);
+#endif
+#if BITS_WORD
+static uint64_t get_bits_w(const void *in, enum uint_typename t, int pos, int nb);
+static uint64_t ld_word(const void *in, enum uint_typename t, int i);
+static void st_word(void *out, enum uint_typename t, int i, uint64_t v);
+#endif
+#if BITS_EXT || BITS_INS
+static boolean_t bad_type(enum uint_typename t);
+#endif
+
 #if TOOLS_EXTRACT_BITS == 1
 /**
  * extract_bits
  */
 void extract_bits(void *in, enum uint_typename in_t, void *out, enum uint_typename out_t, int bits_start, int bits_len)
 {
-	union {
-		uint8_t u8;
-		uint16_t u16;
-		uint32_t u32;
-		uint64_t u64;
-	} v;
-	int s_adr, r_sft, l_sft, out_of, len, out_len;
-	uint8_t *p8 = out;
-	uint16_t *p16 = out;
-        uint32_t *p32 = out;
-        uint64_t *p64 = out;
-
-	out_len = bits_len / 8;
-	if (bits_len % 8) {
-		out_len++;
-	}
-	out_of = 0;
-	len = bits_len;
-	s_adr = bits_start / in_t;
-        r_sft = bits_start % in_t;
-	l_sft = in_t - r_sft;
-	for (int i = s_adr; len > 0; i++) {
-		switch (in_t) {
-		case UI8_TYPE :
-			v.u8 = *((uint8_t *) in + i);
-			if (r_sft) {
-				v.u8 >>= r_sft;
-				if (len > l_sft) {
-					v.u8 |= *((uint8_t *) in + i + 1) << l_sft;
-				}
-			}
-			if (len <= in_t) {
-				uint8_t m = 1 << 7;
-				for (int k = 0; k < in_t - len; k++) {
-					v.u8 &= ~m;
-					m >>= 1;
-				}
-				len = 0;
-			} else {
-				len -= in_t;
+	if (bad_type(in_t) || bad_type(out_t)) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	if (bits_len <= 0) {
+		return;
+	}
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	// Array of little endian words is bit stream ordered from byte 0.
+	int is = __builtin_ctz(in_t), os = __builtin_ctz(out_t);
+
+	ext_bytes(in, (((bits_start + bits_len - 1) >> is) + 1) << (is - 3), out,
+	          ((bits_len + out_t - 1) >> os) << (os - 3), bits_start, bits_len);
+#else
+	int n_out = (bits_len + out_t - 1) / out_t;
+
+	for (int o = 0; o < n_out; o++) {
+		int nb = bits_len - o * out_t;
+
+		st_word(out, out_t, o, get_bits_w(in, in_t, bits_start + o * out_t, nb > out_t ? out_t : nb));
+	}
+#endif
+}
+#endif
+
+#if TOOLS_EXTRACT_BITS_LE == 1
+/**
+ * extract_bits_le
+ */
+void extract_bits_le(void *in, enum uint_typename in_t, void *out, enum uint_typename out_t, int bits_start, int bits_len)
+{
+	if (bad_type(out_t)) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	if (bits_len <= 0) {
+		return;
+	}
+	int os = __builtin_ctz(out_t);
+
+	ext_bytes(in, (bits_start + bits_len + 7) >> 3, out,
+	          ((bits_len + out_t - 1) >> os) << (os - 3), bits_start, bits_len);
+}
+#endif
+
+
+#if TOOLS_INSERT_BITS == 1
+/**
+ * insert_bits
+ */
+void insert_bits(void *out, enum uint_typename out_t, const void *in, enum uint_typename in_t, int bits_start, int bits_len)
+{
+	if (bad_type(in_t) || bad_type(out_t)) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	if (bits_len <= 0) {
+		return;
+	}
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	int is = __builtin_ctz(in_t);
+
+	ins_bytes(out, in, ((bits_len + in_t - 1) >> is) << (is - 3), bits_start, bits_len);
+#else
+	int pos = bits_start, end = bits_start + bits_len;
+
+	while (pos < end) {
+		int i = pos / out_t, r = pos % out_t, nb = out_t - r;
+		uint64_t m, w;
+
+		if (nb > end - pos) {
+			nb = end - pos;
+		}
+		m = (nb < 64 ? ((uint64_t) 1 << nb) - 1 : ~(uint64_t) 0) << r;
+		w = ld_word(out, out_t, i);
+		w = (w & ~m) | ((get_bits_w(in, in_t, pos - bits_start, nb) << r) & m);
+		st_word(out, out_t, i, w);
+		pos += nb;
+	}
+#endif
+}
+#endif
+
+#if TOOLS_INSERT_BITS_LE == 1
+/**
+ * insert_bits_le
+ */
+void insert_bits_le(void *out, enum uint_typename out_t, const void *in, enum uint_typename in_t, int bits_start, int bits_len)
+{
+	if (bad_type(in_t)) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	if (bits_len <= 0) {
+		return;
+	}
+	int is = __builtin_ctz(in_t);
+
+	ins_bytes(out, in, ((bits_len + in_t - 1) >> is) << (is - 3), bits_start, bits_len);
+}
+#endif
+
+#if BITS_EXT || BITS_INS
+/**
+ * bad_type
+ */
+static boolean_t bad_type(enum uint_typename t)
+{
+	return (t != UI8_TYPE && t != UI16_TYPE && t != UI32_TYPE && t != UI64_TYPE);
+}
+#endif
+
+#if BITS_EXT
+/**
+ * ext_bytes
+ *
+ * Copy bits [start, start + len) of byte stream (bit 0 is LSB of byte 0)
+ * to out and clear rest of osz bytes. Bytes from lim are never read.
+ */
+static void ext_bytes(const uint8_t *in, int lim, uint8_t *out, int osz, int start, int len)
+{
+	uint64_t v;
+
+	if (osz <= 8) {
+		// Single window (fields up to 64 bits).
+		v = ld_win(in, lim, start, len);
+		if (len < 64) {
+			v &= ((uint64_t) 1 << len) - 1;
+		}
+		st_win(out, v, osz);
+		return;
+	}
+	if (!(start % 8)) {
+		// Byte aligned, plain copy.
+		int n = (len + 7) / 8;
+
+		memcpy(out, in + start / 8, n);
+		if (len % 8) {
+			*(out + n - 1) &= (1 << len % 8) - 1;
+		}
+		memset(out + n, 0, osz - n);
+		return;
+	}
+	for (int k = 0; k < osz; k += 8, start += 64, len -= 64) {
+		v = ld_win(in, lim, start, len);
+		if (len < 64) {
+			v &= ((uint64_t) 1 << len) - 1;
+		}
+		st_win(out + k, v, osz - k < 8 ? osz - k : 8);
+	}
+}
+
+/**
+ * ld_win
+ *
+ * Load 64-bit window from bit position pos (little endian byte order).
+ * Second load (funnel shift) is done only when nb bits do not fit to first.
+ */
+static uint64_t ld_win(const uint8_t *in, int lim, int pos, int nb)
+{
+	int b = pos / 8, r = pos % 8;
+	uint64_t v;
+
+	v = ld_bytes(in + b, lim - b) >> r;
+	if (r && nb > 64 - r) {
+		v |= (uint64_t) *(in + b + 8) << (64 - r);
+	}
+	return (v);
+}
+#endif
+
+#if BITS_INS
+/**
+ * ins_bytes
+ *
+ * Copy len bits of byte stream in (isz bytes) to bits [start, start + len)
+ * of byte stream out. Other bits of out are preserved, bytes outside of
+ * bit range are neither read nor written.
+ */
+static void ins_bytes(uint8_t *out, const uint8_t *in, int isz, int start, int len)
+{
+	int b = start / 8, r = start % 8, n, nb;
+	uint64_t v, m, w;
+
+	for (int k = 0; len > 0; k += 8, b += 8, len -= 64) {
+		nb = len < 64 ? len : 64;
+		v = ld_bytes(in + k, isz - k);
+		m = nb < 64 ? ((uint64_t) 1 << nb) - 1 : ~(uint64_t) 0;
+		n = (r + nb + 7) / 8;
+		if (n > 8) {
+			n = 8;
+		}
+		if (!r && nb == 64) {
+			// Whole window is overwritten.
+			w = v;
+		} else {
+			w = ld_bytes(out + b, n);
+			w = (w & ~(m << r)) | ((v << r) & (m << r));
+		}
+		st_win(out + b, w, n);
+		if (r + nb > 64) {
+			// Funnel shifted part to byte b + 8.
+			uint8_t hm = m >> (64 - r);
+
+			*(out + b + 8) = (*(out + b + 8) & ~hm) | ((v >> (64 - r)) & hm);
+		}
+	}
+}
+#endif
+
+#if BITS_EXT || BITS_INS || TOOLS_BITS_SCHEMA == 1
+/**
+ * st_win
+ */
+static void st_win(uint8_t *out, uint64_t v, int n)
+{
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	switch (n) {
+	case 1 :
+		*out = v;
+		break;
+	case 2 :
+		{
+			uint16_t w = v;
+
+			memcpy(out, &w, 2);
+		}
+		break;
+	case 4 :
+		{
+			uint32_t w = v;
+
+			memcpy(out, &w, 4);
+		}
+		break;
+	case 8 :
+		memcpy(out, &v, 8);
+		break;
+	default :
+		memcpy(out, &v, n);
+		break;
+	}
+#else
+	for (int i = 0; i < n; i++) {
+		*(out + i) = v >> 8 * i;
+	}
+#endif
+}
+
+/**
+ * ld_bytes
+ *
+ * Load min(m, 8) bytes as little endian value. Short tail is loaded by at
+ * most three power of two sized loads.
+ */
+static uint64_t ld_bytes(const uint8_t *p, int m)
+{
+	uint64_t v = 0;
+	int o = 0;
+
+	if (m >= 8) {
+		return (ld_le(p, 8));
+	}
+	if (m & 4) {
+		v = ld_le(p, 4);
+		o = 4;
+	}
+	if (m & 2) {
+		v |= ld_le(p + o, 2) << 8 * o;
+		o += 2;
+	}
+	if (m & 1) {
+		v |= (uint64_t) *(p + o) << 8 * o;
+	}
+	return (v);
+}
+
+/**
+ * ld_le
+ */
+static inline uint64_t ld_le(const uint8_t *p, int n)
+{
+	uint64_t v = 0;
+
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	switch (n) {
+	case 2 :
+		{
+			uint16_t w;
+
+			memcpy(&w, p, 2);
+			v = w;
+		}
+		break;
+	case 4 :
+		{
+			uint32_t w;
+
+			memcpy(&w, p, 4);
+			v = w;
+		}
+		break;
+	default :
+		memcpy(&v, p, 8);
+		break;
+	}
+#else
+	for (int i = 0; i < n; i++) {
+		v |= (uint64_t) *(p + i) << 8 * i;
+	}
+#endif
+	return (v);
+}
+#endif
+
+#if BITS_WORD
+/**
+ * get_bits_w
+ *
+ * Get nb (up to 64) bits from position pos of word array (value order).
+ */
+static uint64_t get_bits_w(const void *in, enum uint_typename t, int pos, int nb)
+{
+	int i = pos / t, r = pos % t, lim = (pos + nb - 1) / t;
+	uint64_t v;
+
+	v = ld_word(in, t, i) >> r;
+	for (int sh = t - r; sh < nb && i < lim; sh += t) {
+		v |= ld_word(in, t, ++i) << sh;
+	}
+	if (nb < 64) {
+		v &= ((uint64_t) 1 << nb) - 1;
+	}
+	return (v);
+}
+
+/**
+ * ld_word
+ */
+static uint64_t ld_word(const void *in, enum uint_typename t, int i)
+{
+	switch (t) {
+	case UI8_TYPE :
+		return (*((const uint8_t *) in + i));
+	case UI16_TYPE :
+		return (*((const uint16_t *) in + i));
+	case UI32_TYPE :
+		return (*((const uint32_t *) in + i));
+	default :
+		return (*((const uint64_t *) in + i));
+	}
+}
+
+/**
+ * st_word
+ */
+static void st_word(void *out, enum uint_typename t, int i, uint64_t v)
+{
+	switch (t) {
+	case UI8_TYPE :
+		*((uint8_t *) out + i) = v;
+		break;
+	case UI16_TYPE :
+		*((uint16_t *) out + i) = v;
+		break;
+	case UI32_TYPE :
+		*((uint32_t *) out + i) = v;
+		break;
+	default :
+		*((uint64_t *) out + i) = v;
+		break;
+	}
+}
+#endif
+
+#if TOOLS_BITS_SCHEMA == 1
+/**
+ * init_bits_schema
+ */
+void init_bits_schema(struct bits_schema *sch, const struct bits_field *fld, struct bits_op *op, int n, int in_sz,
+                      enum bits_order ord)
+{
+	struct bits_op *wo = NULL;
+	int wb = -1, ln = 0, end;
+	uint64_t wm = 0, wf = 0;
+
+	// Bit positions and output offsets are stored in uint16_t.
+	if (in_sz > (UINT16_MAX + 1) / 8 || (ord != BITS_LSB && ord != BITS_MSB)) {
+		crit_err_exit(BAD_PARAMETER);
+	}
+	for (int i = 0; i < n; i++) {
+		const struct bits_field *f = fld + i;
+		int k = i;
+
+		if (f->len < 1 || f->len > 64 || f->start < 0 || (f->sz != 1 && f->sz != 2 &&
+		    f->sz != 4 && f->sz != 8) || f->len > 8 * f->sz || f->start + f->len > 8 * in_sz ||
+		    f->off < 0 || f->off > UINT16_MAX + 1 - f->sz) {
+			crit_err_exit(BAD_PARAMETER);
+		}
+		// Insertion sort by start bit.
+		while (k > 0 && (op + k - 1)->start > f->start) {
+			*(op + k) = *(op + k - 1);
+			k--;
+		}
+		(op + k)->start = f->start;
+		(op + k)->len = f->len;
+		(op + k)->off = f->off;
+		(op + k)->sz = f->sz;
+		(op + k)->flg = (f->flags & BITS_SIGNED) ? BITS_OP_SIGNED : 0;
+	}
+	for (int i = 0; i < n; i++) {
+		struct bits_op *o = op + i;
+
+		end = o->start + o->len;
+		if (wb < 0 || o->start < 8 * wb || end > 8 * (wb + ln)) {
+			// New window, moved back to end of frame when possible.
+			if (wo && wm == wf) {
+				wo->flg |= BITS_OP_FULL;
 			}
-			switch (out_t) {
-			case UI8_TYPE :
-                                *p8++ = v.u8;
-				break;
-			case UI16_TYPE :
-				if (out_of == 0) {
-					*p16 = v.u8;
-					out_of = 1;
-				} else if (out_of == 1) {
-					*p16 |= v.u8 << 8;
-                                        p16++;
-					out_of = 0;
-				}
-				break;
-			case UI32_TYPE :
-				if (out_of == 0) {
-					*p32 = v.u8;
-					out_of = 1;
-				} else if (out_of == 1) {
-					*p32 |= v.u8 << 8;
-					out_of = 2;
-				} else if (out_of == 2) {
-					*p32 |= v.u8 << 16;
-					out_of = 3;
-				} else if (out_of == 3) {
-					*p32 |= v.u8 << 24;
-                                        p32++;
-					out_of = 0;
-				}
-				break;
-			case UI64_TYPE :
-				if (out_of == 0) {
-					*p64 = v.u8;
-					out_of = 1;
-				} else if (out_of == 1) {
-					*p64 |= v.u8 << 8;
-					out_of = 2;
-				} else if (out_of == 2) {
-					*p64 |= v.u8 << 16;
-					out_of = 3;
-				} else if (out_of == 3) {
-					*p64 |= v.u8 << 24;
-					out_of = 4;
-				} else if (out_of == 4) {
-					*p64 |= (uint64_t) v.u8 << 32;
-					out_of = 5;
-				} else if (out_of == 5) {
-					*p64 |= (uint64_t) v.u8 << 40;
-					out_of = 6;
-				} else if (out_of == 6) {
-					*p64 |= (uint64_t) v.u8 << 48;
-					out_of = 7;
-				} else if (out_of == 7) {
-					*p64 |= (uint64_t) v.u8 << 56;
-                                        p64++;
-					out_of = 0;
-				}
-				break;
-			default :
-				crit_err_exit(BAD_PARAMETER);
-				break;
+			wb = o->start / 8;
+			if (wb + 8 > in_sz) {
+				wb = in_sz >= 8 ? in_sz - 8 : 0;
 			}
-			break;
-                case UI16_TYPE :
-                	v.u16 = *((uint16_t *) in + i);
-			if (r_sft) {
-				v.u16 >>= r_sft;
-				if (len > l_sft) {
-					v.u16 |= *((uint16_t *) in + i + 1) << l_sft;
-				}
+			ln = in_sz - wb < 8 ? in_sz - wb : 8;
+			wf = ln < 8 ? ((uint64_t) 1 << 8 * ln) - 1 : ~(uint64_t) 0;
+			if (ord == BITS_MSB) {
+				wf = __builtin_bswap64(wf);
 			}
-			if (len <= in_t) {
-				uint16_t m = 1 << 15;
-				for (int k = 0; k < in_t - len; k++) {
-					v.u16 &= ~m;
-					m >>= 1;
-				}
-				len = 0;
+			o->flg |= BITS_OP_LOAD;
+			wo = o;
+			wm = 0;
+		}
+		o->wb = wb;
+		o->ln = ln;
+		o->sft = o->start - 8 * wb;
+		o->rsh = 64 - o->len;
+		if (o->sft + o->len > 64) {
+			// Field spans 9 bytes, next byte is funnel shifted in.
+			o->flg |= BITS_OP_HI;
+			if (ord == BITS_LSB) {
+				o->lsh = 64 - o->len;
+				o->msk = ~(uint64_t) 0 << o->sft;
 			} else {
-				len -= in_t;
+				o->lsh = 0;
+				o->msk = ~(uint64_t) 0 >> o->sft;
 			}
-			switch (out_t) {
-			case UI8_TYPE :
-				for (int j = 0; j < 2; j++) {
-					if (out_len) {
-						*p8++ = v.u16 >> 8 * j;
-                                                out_len--;
-					} else {
-						break;
-					}
-				}
-				break;
-			case UI16_TYPE :
-				*p16++ = v.u16;
-				break;
-			case UI32_TYPE :
-				if (out_of == 0) {
-					*p32 = v.u16;
-					out_of = 1;
-				} else if (out_of == 1) {
-					*p32 |= v.u16 << 16;
-					p32++;
-					out_of = 0;
-				}
-				break;
-			case UI64_TYPE :
-				if (out_of == 0) {
-					*p64 = v.u16;
-					out_of = 1;
-				} else if (out_of == 1) {
-					*p64 |= v.u16 << 16;
-					out_of = 2;
-				} else if (out_of == 2) {
-					*p64 |= (uint64_t) v.u16 << 32;
-					out_of = 3;
-				} else if (out_of == 3) {
-					*p64 |= (uint64_t) v.u16 << 48;
-					p64++;
-					out_of = 0;
-				}
-				break;
-			default :
-				crit_err_exit(BAD_PARAMETER);
-				break;
+		} else {
+			if (ord == BITS_MSB) {
+				// MSB window is byte swapped, byte 0 is top of word.
+				o->sft = 64 - o->sft - o->len;
 			}
-			break;
-                case UI32_TYPE :
-                	v.u32 = *((uint32_t *) in + i);
-			if (r_sft) {
-				v.u32 >>= r_sft;
-				if (len > l_sft) {
-					v.u32 |= *((uint32_t *) in + i + 1) << l_sft;
-				}
+			o->lsh = 64 - o->sft - o->len;
+			o->msk = (~(uint64_t) 0 >> o->rsh) << o->sft;
+		}
+		wm |= o->msk;
+	}
+	if (wo && wm == wf) {
+		wo->flg |= BITS_OP_FULL;
+	}
+	sch->op = op;
+	sch->n = n;
+	sch->in_sz = in_sz;
+	sch->ord = ord;
+}
+
+/**
+ * decode_bits
+ */
+void decode_bits(const struct bits_schema *sch, const void *in, void *out)
+{
+	const uint8_t *p = in;
+	boolean_t msb = sch->ord == BITS_MSB;
+	uint64_t w = 0, v;
+
+	for (const struct bits_op *o = sch->op, *e = sch->op + sch->n; o < e; o++) {
+		if (o->flg & BITS_OP_LOAD) {
+			w = ld_bytes(p + o->wb, o->ln);
+			if (msb) {
+				w = __builtin_bswap64(w);
 			}
-			if (len <= in_t) {
-				uint32_t m = 1 << 31;
-				for (int k = 0; k < in_t - len; k++) {
-					v.u32 &= ~m;
-					m >>= 1;
-				}
-				len = 0;
+		}
+		if (o->flg & BITS_OP_HI) {
+			if (msb) {
+				v = (w << o->sft) | *(p + o->wb + 8) >> (8 - o->sft);
 			} else {
-				len -= in_t;
-			}
-			switch (out_t) {
-			case UI8_TYPE :
-				for (int j = 0; j < 4; j++) {
-					if (out_len) {
-						*p8++ = v.u32 >> 8 * j;
-                                                out_len--;
-					} else {
-						break;
-					}
-				}
-				break;
-			case UI16_TYPE :
-				for (int j = 0; j < 2; j++) {
-					if (out_len) {
-						*p16++ = v.u32 >> 16 * j;
-                                                out_len -= 2;
-					} else {
-						break;
-					}
-				}
-				break;
-			case UI32_TYPE :
-				*p32++ = v.u32;
-				break;
-			case UI64_TYPE :
-				if (out_of == 0) {
-					*p64 = v.u32;
-					out_of = 1;
-				} else if (out_of == 1) {
-					*p64 |= (uint64_t) v.u32 << 32;
-                                        p64++;
-					out_of = 0;
-				}
-				break;
-			default :
-				crit_err_exit(BAD_PARAMETER);
-				break;
+				v = (w >> o->sft) | (uint64_t) *(p + o->wb + 8) << (64 - o->sft);
 			}
+		} else {
+			v = w;
+		}
+		v <<= o->lsh;
+		if (o->flg & BITS_OP_SIGNED) {
+			v = (int64_t) v >> o->rsh;
+		} else {
+			v >>= o->rsh;
+		}
+		switch (o->sz) {
+		case 1 :
+			*((uint8_t *) out + o->off) = v;
 			break;
-                case UI64_TYPE :
-                	v.u64 = *((uint64_t *) in + i);
-			if (r_sft) {
-				v.u64 >>= r_sft;
-				if (len > l_sft) {
-					v.u64 |= *((uint64_t *) in + i + 1) << l_sft;
-				}
-			}
-			if (len <= in_t) {
-				uint64_t m = (uint64_t) 1 << 63;
-				for (int k = 0; k < in_t - len; k++) {
-					v.u64 &= ~m;
-					m >>= 1;
-				}
-				len = 0;
-			} else {
-				len -= in_t;
+		case 2 :
+			{
+				uint16_t t = v;
+
+				memcpy((uint8_t *) out + o->off, &t, 2);
 			}
-			switch (out_t) {
-			case UI8_TYPE :
-				for (int j = 0; j < 8; j++) {
-					if (out_len) {
-						*p8++ = v.u64 >> 8 * j;
-                                                out_len--;
-					} else {
-						break;
-					}
-				}
-				break;
-			case UI16_TYPE :
-				for (int j = 0; j < 4; j++) {
-					if (out_len) {
-						*p16++ = v.u64 >> 16 * j;
-						out_len -= 2;
-					} else {
-						break;
-					}
-				}
-				break;
-			case UI32_TYPE :
-				for (int j = 0; j < 2; j++) {
-					if (out_len) {
-						*p32++ = v.u64 >> 32 * j;
-						out_len -= 4;
-					} else {
-						break;
-					}
-				}
-				break;
-			case UI64_TYPE :
-				*p64++ = v.u64;
-				break;
-			default :
-				crit_err_exit(BAD_PARAMETER);
-				break;
+			break;
+		case 4 :
+			{
+				uint32_t t = v;
+
+				memcpy((uint8_t *) out + o->off, &t, 4);
 			}
 			break;
 		default :
-			crit_err_exit(BAD_PARAMETER);
+			memcpy((uint8_t *) out + o->off, &v, 8);
 			break;
 		}
 	}
 }
-#endif
 
-#if TOOLS_EXTRACT_BITS_LE == 1
 /**
- * extract_bits_le
+ * encode_bits
  */
-void extract_bits_le(void *in, enum uint_typename in_t, void *out, enum uint_typename out_t, int bits_start, int bits_len)
+void encode_bits(const struct bits_schema *sch, const void *in, void *out)
 {
-	int s_adr, r_sft, l_sft, out_n;
-	uint8_t *p_out, v;
+	uint8_t *p = out;
+	boolean_t msb = sch->ord == BITS_MSB;
+	const struct bits_op *w_o = NULL;
+	uint64_t w = 0, v;
 
-	s_adr = bits_start / 8;
-        r_sft = bits_start % 8;
-	l_sft = 8 - r_sft;
-	p_out = out;
-	out_n = bits_len / out_t;
-	if (bits_len % out_t) {
-		out_n++;
-	}
-	switch (out_t) {
-	case UI8_TYPE :
-		break;
-	case UI16_TYPE :
-		*((uint16_t *) out + out_n - 1) = 0;
-		break;
-	case UI32_TYPE :
-		*((uint32_t *) out + out_n - 1) = 0;
-		break;
-	case UI64_TYPE :
-		*((uint64_t *) out + out_n - 1) = 0;
-		break;
-	default :
-		crit_err_exit(BAD_PARAMETER);
-		break;
-	}
-        for (int i = s_adr; bits_len > 0; i++) {
-		v = *((uint8_t *) in + i);
-		if (r_sft) {
-			v >>= r_sft;
-                        if (bits_len > l_sft) {
-				v |= *((uint8_t *) in + i + 1) << l_sft;
+	for (const struct bits_op *o = sch->op, *e = sch->op + sch->n; o < e; o++) {
+		if (o->flg & BITS_OP_LOAD) {
+			if (w_o) {
+				st_win(p + w_o->wb, msb ? __builtin_bswap64(w) : w, w_o->ln);
+			}
+			w_o = o;
+			w = (o->flg & BITS_OP_FULL) ? 0 : ld_bytes(p + o->wb, o->ln);
+			if (msb) {
+				w = __builtin_bswap64(w);
 			}
 		}
-		if (bits_len <= 8) {
-			uint8_t m = 1 << 7;
-			for (int k = 0; k < 8 - bits_len; k++) {
-				v &= ~m;
-				m >>= 1;
+		switch (o->sz) {
+		case 1 :
+			v = *((const uint8_t *) in + o->off);
+			break;
+		case 2 :
+			{
+				uint16_t t;
+
+				memcpy(&t, (const uint8_t *) in + o->off, 2);
+				v = t;
 			}
-			bits_len = 0;
+			break;
+		case 4 :
+			{
+				uint32_t t;
+
+				memcpy(&t, (const uint8_t *) in + o->off, 4);
+				v = t;
+			}
+			break;
+		default :
+			memcpy(&v, (const uint8_t *) in + o->off, 8);
+			break;
+		}
+		if ((o->flg & BITS_OP_HI) && msb) {
+			int r = o->sft + o->len - 64;
+			uint8_t hm = 0xFF << (8 - r);
+
+			w = (w & ~o->msk) | ((v >> r) & o->msk);
+			*(p + o->wb + 8) = (*(p + o->wb + 8) & ~hm) | ((v << (8 - r)) & hm);
 		} else {
-			bits_len -= 8;
+			w = (w & ~o->msk) | ((v << o->sft) & o->msk);
+			if (o->flg & BITS_OP_HI) {
+				uint8_t hm = ((uint64_t) 1 << (o->sft + o->len - 64)) - 1;
+
+				*(p + o->wb + 8) = (*(p + o->wb + 8) & ~hm) | ((v >> (64 - o->sft)) & hm);
+			}
 		}
-                *p_out++ = v;
+	}
+	if (w_o) {
+		st_win(p + w_o->wb, msb ? __builtin_bswap64(w) : w, w_o->ln);
 	}
 }
 #endif
@@ -19,6 +19,10 @@
 #ifndef TOOLS_H
 #define TOOLS_H
 
+#ifndef TOOLS_TXT_TBL_CHECK
+ #define TOOLS_TXT_TBL_CHECK 0
+#endif
+
 #ifndef TOOLS_EXTRACT_BITS
  #define TOOLS_EXTRACT_BITS 0
 #endif
@@ -27,6 +31,18 @@
  #define TOOLS_EXTRACT_BITS_LE 0
 #endif
 
+#ifndef TOOLS_INSERT_BITS
+ #define TOOLS_INSERT_BITS 0
+#endif
+
+#ifndef TOOLS_INSERT_BITS_LE
+ #define TOOLS_INSERT_BITS_LE 0
+#endif
+
+#ifndef TOOLS_BITS_SCHEMA
+ #define TOOLS_BITS_SCHEMA 0
+#endif
+
 struct txt_item {
 	int idx;
 	const char *str;
@@ -37,6 +53,63 @@ struct txt_item {
  */
 const char *find_txt_item(int val, const struct txt_item *ary, const char *nf);
 
+enum txt_tbl_type {
+	TXT_TBL_DIRECT,
+	TXT_TBL_SORTED
+};
+
+/*
+ * Indexed text table. Form is chosen by declaration macro:
+ * TXT_TBL_DIRECT_DEF - dense values, string array indexed by (val - base),
+ *   unused indexes are NULL (designated initializers can be used).
+ * TXT_TBL_SORTED_DEF - sparse values, txt_item array sorted by idx
+ *   (ascending, unique), binary search. No terminating item.
+ */
+struct txt_tbl {
+	enum txt_tbl_type type;
+	int base;
+	int n;
+	const char *const *str;
+	const struct txt_item *item;
+};
+
+#define TXT_TBL_DIRECT_DEF(nm, base, ...)\
+	static const char *const nm##_str[] = {__VA_ARGS__};\
+	static const struct txt_tbl nm = {TXT_TBL_DIRECT, (base),\
+		sizeof(nm##_str) / sizeof(nm##_str[0]), nm##_str, NULL}
+
+#define TXT_TBL_SORTED_DEF(nm, ...)\
+	static const struct txt_item nm##_item[] = {__VA_ARGS__};\
+	static const struct txt_tbl nm = {TXT_TBL_SORTED, 0,\
+		sizeof(nm##_item) / sizeof(nm##_item[0]), NULL, nm##_item}
+
+/**
+ * find_txt
+ *
+ * Find text in indexed table (O(1) for direct table, O(log n) for sorted).
+ *
+ * @tbl: Pointer to table.
+ * @val: Value.
+ * @nf: Text returned if value is not found.
+ *
+ * Returns: Text.
+ */
+const char *find_txt(const struct txt_tbl *tbl, int val, const char *nf);
+
+#if TOOLS_TXT_TBL_CHECK == 1
+/**
+ * check_txt_tbl
+ *
+ * Debug check of sorted table (ascending and unique idx). Invalid table
+ * causes crit_err_exit(BAD_PARAMETER). Use CHECK_TXT_TBL() macro (empty if
+ * TOOLS_TXT_TBL_CHECK is 0).
+ */
+void check_txt_tbl(const struct txt_tbl *tbl);
+#define CHECK_TXT_TBL(tbl) check_txt_tbl(tbl)
+#else
+#define CHECK_TXT_TBL(tbl)
+#endif
+
 /**
  * prn_bv_pos
  */
@@ -52,6 +125,38 @@ void prn_bv_str(char *s, unsigned int n, int sz);
  */
 boolean_t conv_bv_sz(const char *s, unsigned int *n, int sz);
 
+// Buffer size for prn_bv64() output (sz bits, group of grp bits).
+#define BV_STR_SIZE(sz, grp) ((sz) + ((grp) > 0 ? ((sz) - 1) / (grp) : 0) + 1)
+
+/**
+ * prn_bv64
+ *
+ * Print sz (1 - 64) low bits of n as '0'/'1' characters (MSB first),
+ * characters are produced 4 at a time from nibble table. Groups of grp
+ * bits (counted from LSB) are separated by space, grp 0 disables grouping.
+ *
+ * @s: Pointer to output buffer (BV_STR_SIZE(sz, grp) bytes).
+ * @n: Value.
+ * @sz: Number of bits.
+ * @grp: Group size or 0.
+ *
+ * Returns: Length of string (without '\0').
+ */
+int prn_bv64(char *s, uint64_t n, int sz, int grp);
+
+/**
+ * conv_bv64
+ *
+ * Parse bit vector string ('0', '1' and spaces) in one pass.
+ *
+ * @s: Pointer to string.
+ * @n: Pointer to value (written only on success).
+ * @sz: Required number of bits (1 - 64).
+ *
+ * Returns: TRUE if string is valid and has exactly sz bits.
+ */
+boolean_t conv_bv64(const char *s, uint64_t *n, int sz);
+
 /**
  * num_diff
  */
@@ -64,9 +169,77 @@ int bit_pos(unsigned int bmp);
 
 /**
  * long_division
+ *
+ * Same as udiv64(n, d, NULL).
  */
 unsigned long long long_division(unsigned long long n, unsigned long long d);
 
+/**
+ * udiv64
+ *
+ * 64-bit unsigned division for targets without 64-bit divider. Operands
+ * fitting to 32 bits use native divider, divisors up to 16 bits use four
+ * 32/16 bit steps, other divisions run shift-subtract only for significant
+ * quotient bits (CLZ). Division by zero returns all ones quotient and
+ * remainder n.
+ *
+ * @n: Dividend.
+ * @d: Divisor.
+ * @rem: Pointer to remainder or NULL.
+ *
+ * Returns: Quotient.
+ */
+uint64_t udiv64(uint64_t n, uint64_t d, uint64_t *rem);
+
+// Precomputed reciprocal for repeated division by same runtime value.
+struct udiv64_rcp {
+	uint64_t m;
+	uint64_t d;
+	uint8_t sh;
+	boolean_t add;
+};
+
+/**
+ * init_udiv64_rcp
+ *
+ * Compute reciprocal of d (slow, once). d = 0 causes
+ * crit_err_exit(BAD_PARAMETER).
+ *
+ * @rc: Pointer to reciprocal.
+ * @d: Divisor.
+ */
+void init_udiv64_rcp(struct udiv64_rcp *rc, uint64_t d);
+
+/**
+ * udiv64_rcp
+ *
+ * Division by precomputed reciprocal (one 64x64 -> 128 bit multiply and
+ * shifts).
+ *
+ * @rc: Pointer to reciprocal.
+ * @n: Dividend.
+ * @rem: Pointer to remainder or NULL.
+ *
+ * Returns: Quotient.
+ */
+uint64_t udiv64_rcp(const struct udiv64_rcp *rc, uint64_t n, uint64_t *rem);
+
+/**
+ * muldiv64
+ *
+ * Compute a * b / c with 128-bit intermediate product.
+ *
+ * @a: Multiplicand.
+ * @b: Multiplier.
+ * @c: Divisor.
+ * @q: Pointer to quotient.
+ * @rem: Pointer to remainder or NULL.
+ *
+ * Returns: FALSE if c is 0 or quotient does not fit to 64 bits (*q and
+ *   *rem are not changed).
+ */
+boolean_t muldiv64(uint64_t a, uint64_t b, uint64_t c, uint64_t *q, uint64_t *rem);
+
 enum uint_typename {
 	UI8_TYPE = 8,
 	UI16_TYPE = 16,
@@ -85,6 +258,8 @@ enum uint_typename {
  * @in_t: Type of input array member (enum uint_typename).
  * @out: Pointer to output memory area (starting address of array).
  *   Output memory area size must be sufficient to store output bits.
+ *   Exactly ceil(bits_len / out_t) members are written, unused high bits
+ *   of last member are cleared.
  * @out_t: Type of ouput array member (enum uint_typename).
  * @bits_start: Address of bits sequence for extract.
  * @bits_len: Number of bits in extracted sequence.
@@ -103,6 +278,8 @@ void extract_bits(void *in, enum uint_typename in_t, void *out, enum uint_typena
  * @in_t: Type of input array member (enum uint_typename).
  * @out: Pointer to output memory area (starting address of array).
  *   Output memory area size must be sufficient to store output bits.
+ *   Exactly ceil(bits_len / out_t) members are written, unused high bits
+ *   of last member are cleared.
  * @out_t: Type of ouput array member (enum uint_typename).
  * @bits_start: Address of bits sequence for extract.
  * @bits_len: Number of bits in extracted sequence.
@@ -110,4 +287,147 @@ void extract_bits(void *in, enum uint_typename in_t, void *out, enum uint_typena
 void extract_bits_le(void *in, enum uint_typename in_t, void *out, enum uint_typename out_t, int bits_start, int bits_len);
 #endif
 
+#if TOOLS_INSERT_BITS == 1
+/**
+ * insert_bits
+ *
+ * Inserts bits to memory area organized as array composed of integer
+ * types with exact width (inverse of extract_bits()). Other bits of output
+ * area are preserved.
+ *
+ * @out: Pointer to output memory area (starting address of array).
+ * @out_t: Type of output array member (enum uint_typename).
+ * @in: Pointer to input memory area (starting address of array), bit 0 of
+ *   member 0 is first inserted bit.
+ * @in_t: Type of input array member (enum uint_typename).
+ * @bits_start: Address of bits sequence in output area.
+ * @bits_len: Number of bits in inserted sequence.
+ */
+void insert_bits(void *out, enum uint_typename out_t, const void *in, enum uint_typename in_t, int bits_start, int bits_len);
+#endif
+
+#if TOOLS_INSERT_BITS_LE == 1
+/**
+ * insert_bits_le (little endian)
+ *
+ * Inserts bits to memory area organized as array composed of integer
+ * types with exact width (inverse of extract_bits_le()). Other bits of
+ * output area are preserved.
+ *
+ * @out: Pointer to output memory area (starting address of array).
+ * @out_t: Type of output array member (enum uint_typename).
+ * @in: Pointer to input memory area (starting address of array), bit 0 of
+ *   member 0 is first inserted bit.
+ * @in_t: Type of input array member (enum uint_typename).
+ * @bits_start: Address of bits sequence in output area.
+ * @bits_len: Number of bits in inserted sequence.
+ */
+void insert_bits_le(void *out, enum uint_typename out_t, const void *in, enum uint_typename in_t, int bits_start, int bits_len);
+#endif
+
+#if TOOLS_BITS_SCHEMA == 1
+#include <stddef.h>
+
+#define BITS_SIGNED 0x01
+
+/*
+ * Frame bit order. BITS_LSB addresses bits as extract_bits_le() (bit 0 is
+ * LSB of byte 0, field value is stored from its LSB). BITS_MSB is network
+ * order (bit 0 is MSB of byte 0, field value is stored from its MSB).
+ */
+enum bits_order {
+	BITS_LSB,
+	BITS_MSB
+};
+
+/*
+ * Field descriptor, start is bit address in schema order.
+ */
+struct bits_field {
+	int start; // First bit.
+	int len; // Number of bits (1 - 64).
+	int flags; // BITS_SIGNED (sign extend to output member).
+	int off; // Offset of output member.
+	int sz; // Size of output member (1, 2, 4, 8).
+};
+
+/**
+ * BITS_FIELD
+ *
+ * Field descriptor initializer for member mbr of output struct typ.
+ */
+#define BITS_FIELD(start, len, flags, typ, mbr)\
+	{(start), (len), (flags), offsetof(typ, mbr), sizeof(((typ *) 0)->mbr)}
+
+#define BITS_OP_LOAD 0x01
+#define BITS_OP_HI 0x02
+#define BITS_OP_SIGNED 0x04
+#define BITS_OP_FULL 0x08
+
+// Compiled field (private).
+struct bits_op {
+	uint64_t msk;
+	uint16_t start;
+	uint16_t off;
+	uint16_t wb;
+	uint8_t ln;
+	uint8_t len;
+	uint8_t sz;
+	uint8_t sft;
+	uint8_t lsh;
+	uint8_t rsh;
+	uint8_t flg;
+};
+
+struct bits_schema {
+	const struct bits_op *op;
+	int n;
+	int in_sz;
+	enum bits_order ord;
+};
+
+/**
+ * init_bits_schema
+ *
+ * Compile field descriptors. Fields are sorted by start bit and assigned to
+ * 64-bit windows of input frame, adjacent fields share one window load.
+ * Frame is limited to 8192 bytes and output struct to 65536 bytes. Invalid
+ * descriptor causes crit_err_exit(BAD_PARAMETER).
+ *
+ * @sch: Pointer to schema.
+ * @fld: Pointer to array of field descriptors (any order).
+ * @op: Pointer to array of n compiled fields (storage for schema).
+ * @n: Number of fields.
+ * @in_sz: Frame size in bytes (bytes beyond frame are never read).
+ * @ord: Frame bit order (enum bits_order).
+ */
+void init_bits_schema(struct bits_schema *sch, const struct bits_field *fld, struct bits_op *op, int n, int in_sz,
+                      enum bits_order ord);
+
+/**
+ * decode_bits
+ *
+ * Decode all fields of frame in one forward pass.
+ *
+ * @sch: Pointer to compiled schema.
+ * @in: Pointer to frame (sch->in_sz bytes).
+ * @out: Pointer to output struct.
+ */
+void decode_bits(const struct bits_schema *sch, const void *in, void *out);
+
+/**
+ * encode_bits
+ *
+ * Encode all fields to frame in one forward pass. Each window is read,
+ * modified with precomputed field masks and written back once. Windows
+ * completely covered by fields are not read. Frame bits not covered by any
+ * field are preserved. Field values are truncated to field length.
+ *
+ * @sch: Pointer to compiled schema.
+ * @in: Pointer to input struct.
+ * @out: Pointer to frame (sch->in_sz bytes).
+ */
+void encode_bits(const struct bits_schema *sch, const void *in, void *out);
+#endif
+
 #endif
@@ -32,9 +32,22 @@
 
 #if TERMOUT == 1
 
+// Record length is stored in one byte.
+#define TOUT_REC_MAX (TERMOUT_MAX_ROW_LENGTH < 254 ? TERMOUT_MAX_ROW_LENGTH : 254)
+
+enum {
+	PUT_OK,
+	PUT_NOSPC,
+	PUT_QFULL
+};
+
 static char buff[TERMOUT_BUFFER_SIZE + 2 * (TERMOUT_MAX_ROW_LENGTH + 1)];
 static TaskHandle_t tsk_hndl;
+#if TERMIO == 1
+static uint32_t io_ev;
+#else
 static const char *const tsk_nm = "TOUT";
+#endif
 static void *odv;
 static int (*sfn)(void *, void *, int);
 #if TERMOUT_SLEEP == 1
@@ -48,7 +61,13 @@ static char *p_bf_st, *p_bf_en, *p_msg_in, *p_msg_out, *p_msg_last;
 static int mign_cnt, qfull_cnt, serr_cnt, mprn_cnt, prnerr_cnt;
 
 static void add_msg(const char *fmt, va_list argp);
+static int fmt_msg(const char *fmt, va_list argp);
+static int put_msg(int msz);
+static boolean_t out_wait(void);
+#if TERMIO != 1
 static void tout_tsk(void *p);
+#endif
+static void snd_msg(char *p_m);
 #if TERMOUT_SLEEP == 1
 static void sleep_clbk(enum sleep_cmd cmd, ...);
 #endif
@@ -86,14 +105,20 @@ void init_tout(int (*p_snd_fn)(void *, void *, int), void *p_odev)
         if (mque == NULL) {
                 crit_err_exit(MALLOC_ERROR);
         }
+#if TERMIO != 1
         if (pdPASS != xTaskCreate(tout_tsk, tsk_nm, TERMOUT_STACK_SIZE, NULL,
 				  TERMOUT_TASK_PRIO, &tsk_hndl)) {
                 crit_err_exit(MALLOC_ERROR);
         }
+#endif
 #if TERMOUT_SLEEP == 1
 	reg_sleep_clbk(sleep_clbk, SLEEP_PRIO_SUSP_LAST);
 #endif
         ini = TRUE;
+#if TERMIO == 1
+	add_msg_tout("tout.c: row=%d que=%d buf=%d\n", TERMOUT_MAX_ROW_LENGTH,
+	             TERMOUT_MAX_ROWS_IN_QUEUE, TERMOUT_BUFFER_SIZE);
+#endif
 #if TERMOUT_SEND_CLS_ON_START == 1
 	add_msg_tout("\033[2J\033[0;0f");
 #endif
@@ -130,30 +155,75 @@ void v_add_msg_tout(const char *fmt, va_list argp)
  */
 static void add_msg(const char *fmt, va_list argp)
 {
-        int msz, i;
-        char *p_new, *p_new0, *p_act, *p_tmp;
-	boolean_t ov = FALSE;
+        int msz, ret;
 
 	xSemaphoreTake(mtx, portMAX_DELAY);
+	msz = fmt_msg(fmt, argp);
+	if (msz > 0) {
+		ret = put_msg(msz);
+#if TERMIO == 1
+		// Console task is the only one which frees space.
+		while (ret != PUT_OK && xTaskGetCurrentTaskHandle() == tsk_hndl &&
+		       tout_io_drain()) {
+			ret = put_msg(msz);
+		}
+#endif
+		switch (ret) {
+		case PUT_NOSPC :
+			mign_cnt++;
+			break;
+		case PUT_QFULL :
+			qfull_cnt++;
+			break;
+		default :
+			break;
+		}
+	}
+	xSemaphoreGive(mtx);
+}
+
+/**
+ * fmt_msg
+ *
+ * Format message to p_msg_in, truncate it to TERMOUT_MAX_ROW_LENGTH (mutex
+ * must be held).
+ *
+ * Returns: Message size, 0 - nothing to output.
+ */
+static int fmt_msg(const char *fmt, va_list argp)
+{
+        int msz;
+
 	msz = vsnprintf(p_msg_in, TERMOUT_MAX_ROW_LENGTH + 1, fmt, argp);
         if (msz < 0) {
 		prnerr_cnt++;
-                goto exit;
-        } else if (msz == 0) {
-                goto exit;
+		return (0);
 	}
-        if (msz > TERMOUT_MAX_ROW_LENGTH) {
-                msz = TERMOUT_MAX_ROW_LENGTH;
-		ov = TRUE;
-        }
+	if (msz > TERMOUT_MAX_ROW_LENGTH) {
+		msz = TERMOUT_MAX_ROW_LENGTH;
+		*(p_msg_in + msz - 1) = '\n';
+	}
+	return (msz);
+}
+
+/**
+ * put_msg
+ *
+ * Copy msz bytes from p_msg_in to ring buffer and queue record (mutex must
+ * be held).
+ */
+static int put_msg(int msz)
+{
+        int i;
+        char *p_new, *p_new0, *p_act, *p_tmp;
+
 	if (p_msg_last) {
                 if (pdFALSE == xQueuePeek(mque, &p_act, 0)) {
                         p_act = NULL;
 #if TERMOUT_SLEEP == 1
 		} else {
 			if (p_act == NULL) {
-				mign_cnt++;
-				goto exit;
+				return (PUT_NOSPC);
 			}
 #endif
 		}
@@ -164,22 +234,19 @@ static void add_msg(const char *fmt, va_list argp)
                 if (p_act) {
 			if (p_msg_last < p_act) {
 				if (p_new0 + msz >= p_act) {
-					mign_cnt++;
-					goto exit;
+					return (PUT_NOSPC);
 				}
 			} else if (p_msg_last > p_act) {
 				if (p_new0 > p_bf_en) {
 					if (p_new + msz >= p_act) {
-						mign_cnt++;
-						goto exit;
+						return (PUT_NOSPC);
 					}
 				} else {
 					if (p_new0 + msz > p_bf_en) {
 						ptrdiff_t pd;
 						pd = p_new0 + msz - p_bf_en - 1;
 						if (p_bf_st + pd >= p_act) {
-							mign_cnt++;
-							goto exit;
+							return (PUT_NOSPC);
 						}
 					}
 				}
@@ -188,9 +255,6 @@ static void add_msg(const char *fmt, va_list argp)
 	} else {
 		p_new = p_bf_st;
 	}
-	if (ov) {
-		*(p_msg_in + msz - 1) = '\n';
-	}
         *((uint8_t *) p_new) = msz + 1;
         p_tmp = p_new + 1;
         for (i = 0; i < msz; i++) {
@@ -200,21 +264,180 @@ static void add_msg(const char *fmt, va_list argp)
                 *p_tmp++ = *(p_msg_in + i);
         }
         if (errQUEUE_FULL == xQueueSend(mque, &p_new, 0)) {
-                qfull_cnt++;
-        } else {
-                p_msg_last = p_new;
+                return (PUT_QFULL);
         }
-exit:
-	xSemaphoreGive(mtx);
+	p_msg_last = p_new;
+#if TERMIO == 1
+	if (tsk_hndl) {
+		xTaskNotify(tsk_hndl, io_ev, eSetBits);
+	}
+#endif
+	return (PUT_OK);
+}
+
+/**
+ * tout_hexdump
+ */
+void tout_hexdump(const void *addr, int len, int flags)
+{
+	static const char hex_dig[16] = {
+		'0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f'
+	};
+	const uint8_t *p = addr;
+	int w, lsz, rsz, ad, ofs = 0, n, k;
+	uintptr_t a;
+	char *d;
+
+	if (!ini || len <= 0) {
+		return;
+	}
+	w = flags & TOUT_HEX_WIDTH_MASK;
+	if (w == 0) {
+		w = 16;
+	}
+	// Address digits, offset has 8.
+	ad = (flags & TOUT_HEX_ADDR) ? 2 * sizeof(uintptr_t) : 8;
+	// Address, ": ", hex columns, ASCII column, line end.
+	lsz = ad + 2 + 3 * w + ((flags & TOUT_HEX_ASCII) ? 1 + w : 0) + 2;
+	rsz = TOUT_REC_MAX;
+	if (lsz > rsz) {
+		if (flags & TOUT_HEX_ASCII) {
+			w = (rsz - ad - 5) / 4;
+		} else {
+			w = (rsz - ad - 4) / 3;
+		}
+		if (w < 1) {
+			// No line fits to record.
+			return;
+		}
+		lsz = ad + 2 + 3 * w + ((flags & TOUT_HEX_ASCII) ? 1 + w : 0) + 2;
+	}
+	while (ofs < len) {
+		xSemaphoreTake(mtx, portMAX_DELAY);
+		d = p_msg_in;
+		for (k = ofs; k < len && d + lsz <= p_msg_in + rsz; k += w) {
+			n = len - k < w ? len - k : w;
+			a = (flags & TOUT_HEX_ADDR) ? (uintptr_t) (p + k) : (uintptr_t) k;
+			for (int i = 4 * ad - 4; i >= 0; i -= 4) {
+				*d++ = hex_dig[(a >> i) & 0x0F];
+			}
+			*d++ = ':';
+			*d++ = ' ';
+			for (int i = 0; i < w; i++) {
+				if (i < n) {
+					*d++ = hex_dig[*(p + k + i) >> 4];
+					*d++ = hex_dig[*(p + k + i) & 0x0F];
+				} else {
+					*d++ = ' ';
+					*d++ = ' ';
+				}
+				*d++ = ' ';
+			}
+			if (flags & TOUT_HEX_ASCII) {
+				*d++ = ' ';
+				for (int i = 0; i < n; i++) {
+					uint8_t c = *(p + k + i);
+
+					*d++ = (c >= 0x20 && c < 0x7F) ? c : '.';
+				}
+			}
+			// Inner lines end with CRLF, last one with LF (see snd_msg()).
+			*d++ = '\r';
+			*d++ = '\n';
+		}
+		*(d - 2) = '\n';
+		switch (put_msg(d - p_msg_in - 1)) {
+		case PUT_OK :
+			ofs = k;
+			xSemaphoreGive(mtx);
+			break;
+		default :
+			// Ring or queue full, wait for output.
+			xSemaphoreGive(mtx);
+			if (!out_wait()) {
+				return;
+			}
+			break;
+		}
+	}
+}
+
+/**
+ * add_msg_tout_wait
+ */
+void add_msg_tout_wait(const char *fmt, ...)
+{
+	va_list argp, ap;
+	int msz;
+
+	if (!ini) {
+		return;
+	}
+	va_start(argp, fmt);
+	do {
+		// Message is formatted again after wait, p_msg_in is shared.
+		xSemaphoreTake(mtx, portMAX_DELAY);
+		va_copy(ap, argp);
+		msz = fmt_msg(fmt, ap);
+		va_end(ap);
+		if (!msz || PUT_OK == put_msg(msz)) {
+			xSemaphoreGive(mtx);
+			break;
+		}
+		xSemaphoreGive(mtx);
+	} while (out_wait());
+	va_end(argp);
+}
+
+/**
+ * out_wait
+ *
+ * Wait for output of some record (mutex must not be held).
+ *
+ * Returns: FALSE - output disabled.
+ */
+static boolean_t out_wait(void)
+{
+#if TERMIO == 1
+	if (xTaskGetCurrentTaskHandle() == tsk_hndl) {
+		tout_io_drain();
+		return (TRUE);
+	}
+#endif
+	vTaskDelay(1);
+	return (ini);
+}
+
+#if TERMIO == 1
+/**
+ * tout_io_attach
+ */
+void tout_io_attach(TaskHandle_t hndl, uint32_t ev)
+{
+	io_ev = ev;
+	tsk_hndl = hndl;
 }
 
+/**
+ * tout_io_drain
+ */
+boolean_t tout_io_drain(void)
+{
+        char *p_m;
+
+	if (pdFALSE == xQueuePeek(mque, &p_m, 0)) {
+		return (FALSE);
+	}
+	snd_msg(p_m);
+	return (TRUE);
+}
+#else
 /**
  * tout_tsk
  */
 static void tout_tsk(void *p)
 {
         char *p_m;
-        int i, sz;
 
 	add_msg_tout("tout.c: row=%d que=%d buf=%d\n", TERMOUT_MAX_ROW_LENGTH,
 	             TERMOUT_MAX_ROWS_IN_QUEUE, TERMOUT_BUFFER_SIZE);
@@ -227,26 +450,37 @@ static void tout_tsk(void *p)
 			continue;
 		}
 #endif
-		sz = *((uint8_t *) p_m);
-		sz--;
-		p_m++;
-		for (i = 0; i < sz; i++) {
-                        if (p_m > p_bf_en) {
-                                p_m = p_bf_st;
-                        }
-			*(p_msg_out + i) = *p_m++;
-		}
-		if (*(p_msg_out + i - 1) == '\n') {
-			*(p_msg_out + i - 1) = '\r';
-			*(p_msg_out + i) = '\n';
-			sz++;
-		}
-                xQueueReceive(mque, &p_m, 0);
-                if (0 != (*sfn)(odv, p_msg_out, sz)) {
-			serr_cnt++;
-		} else {
-			mprn_cnt++;
-		}
+		snd_msg(p_m);
+	}
+}
+#endif
+
+/**
+ * snd_msg
+ */
+static void snd_msg(char *p_m)
+{
+        int i, sz;
+
+	sz = *((uint8_t *) p_m);
+	sz--;
+	p_m++;
+	for (i = 0; i < sz; i++) {
+                if (p_m > p_bf_en) {
+                        p_m = p_bf_st;
+                }
+		*(p_msg_out + i) = *p_m++;
+	}
+	if (*(p_msg_out + i - 1) == '\n') {
+		*(p_msg_out + i - 1) = '\r';
+		*(p_msg_out + i) = '\n';
+		sz++;
+	}
+        xQueueReceive(mque, &p_m, 0);
+        if (0 != (*sfn)(odv, p_msg_out, sz)) {
+		serr_cnt++;
+	} else {
+		mprn_cnt++;
 	}
 }
 
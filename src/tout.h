@@ -25,6 +25,10 @@
  #define TERMOUT_SLEEP 0
 #endif
 
+#ifndef TERMIO
+ #define TERMIO 0
+#endif
+
 #include <stdarg.h>
 
 #if TERMOUT_SLEEP == 1
@@ -55,6 +59,58 @@ void add_msg_tout(const char *fmt, ...);
  */
 void v_add_msg_tout(const char *fmt, va_list argp);
 
+/**
+ * add_msg_tout_wait
+ *
+ * Same as add_msg_tout(), but if ring buffer or queue is full, caller
+ * waits (vTaskDelay()) until output task frees space instead of dropping
+ * message. For long listings which must be complete (e.g. prof_dump()).
+ */
+void add_msg_tout_wait(const char *fmt, ...);
+
+#define TOUT_HEX_WIDTH_MASK 0x00FF
+#define TOUT_HEX_ADDR 0x0100
+#define TOUT_HEX_ASCII 0x0200
+
+/**
+ * tout_hexdump
+ *
+ * Hex dump of memory area. Lines are formatted without vsnprintf() and
+ * packed to multi-line records (up to TERMOUT_MAX_ROW_LENGTH), so large
+ * dump takes few queue slots. If ring buffer or queue is full, caller
+ * waits (vTaskDelay()) until output task frees space, no line is dropped.
+ *
+ * @addr: Pointer to memory area.
+ * @len: Size of memory area.
+ * @flags: Bytes per line (TOUT_HEX_WIDTH_MASK bits, 0 is 16; reduced if
+ *   line does not fit to record, nothing is printed if not even one byte
+ *   fits), TOUT_HEX_ADDR (first column is address with all uintptr_t
+ *   digits, 8 digit offset otherwise), TOUT_HEX_ASCII (ASCII column).
+ */
+void tout_hexdump(const void *addr, int len, int flags);
+
+#if TERMIO == 1
+/**
+ * tout_io_attach
+ *
+ * Single console task mode (TERMIO). Output has no own task, records are
+ * sent by task registered here (console task created by init_tin()).
+ *
+ * @hndl: Console task handle.
+ * @ev: Notification bits set (eSetBits) for every new record.
+ */
+void tout_io_attach(TaskHandle_t hndl, uint32_t ev);
+
+/**
+ * tout_io_drain
+ *
+ * Send one pending record (if any).
+ *
+ * Returns: TRUE - record sent; FALSE - queue empty.
+ */
+boolean_t tout_io_drain(void);
+#endif
+
 /**
  * tout_stats
  */
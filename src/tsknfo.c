@@ -24,57 +24,97 @@
 #include "sysconf.h"
 #include "criterr.h"
 #include "msgconf.h"
-#include "fmalloc.h"
 #include "tsknfo.h"
 #include <string.h>
 
-#if TERMOUT == 1 && configUSE_TRACE_FACILITY == 1
+#if configUSE_TRACE_FACILITY == 1
 
 /**
- * print_task_info
+ * task_snap
  */
-void print_task_info(void)
+int task_snap(struct task_snap *snap)
 {
-	char *p_bf, *p_r;
-	boolean_t lst = FALSE;
-	int i;
-	UBaseType_t prio;
+	tsk_rt_t tot = 0;
+	int k;
 
-	if (NULL == (p_bf = pvPortMalloc(V_TASK_LIST_BUFFER_SIZE))) {
-		crit_err_exit(MALLOC_ERROR);
+	// Idle task may free TCB of deleted task with its name.
+	vTaskSuspendAll();
+	snap->n = uxTaskGetSystemState(snap->st, TSKNFO_MAX_TASKS, &tot);
+	for (k = 0; k < snap->n; k++) {
+		strncpy(snap->nm[k], snap->st[k].pcTaskName, configMAX_TASK_NAME_LEN - 1);
+		snap->nm[k][configMAX_TASK_NAME_LEN - 1] = '\0';
+		snap->st[k].pcTaskName = snap->nm[k];
 	}
-	memset(p_bf, 0xEE, V_TASK_LIST_BUFFER_SIZE);
-	vTaskList(p_bf);
-	if (*p_bf == 0x00) {
-		crit_err_exit(MALLOC_ERROR);
+	xTaskResumeAll();
+	if (snap->n == 0) {
+		return (-1);
 	}
-	prio = uxTaskPriorityGet(NULL);
-	vTaskPrioritySet(NULL, TASK_PRIO_HIGH);
-	msg(INF, "Name\t\tStat\tPrio\tStckFre\tTCBn\n");
-	p_r = p_bf;
-	while (!lst) {
-		i = 0;
-		while (*(p_r + i) != '\r') {
-			i++;
-		}
-		if (*(p_r + i + 2) == '\0') {
-			lst = TRUE;
+#if configGENERATE_RUN_TIME_STATS == 1
+	tsk_rt_t dt = tot - snap->ptot, d;
+
+	for (int i = 0; i < snap->n; i++) {
+		// Task not found in previous snapshot was created after it.
+		d = snap->st[i].ulRunTimeCounter;
+		for (k = 0; k < snap->pn; k++) {
+			if (snap->pnum[k] == snap->st[i].xTaskNumber) {
+				d -= snap->prt[k];
+				break;
+			}
 		}
-		*(p_r + i) = '\n';
-		*(p_r + i + 1) = '\0';
-		add_msg_tout(p_r);
-		p_r += i + 2;
+		snap->load[i] = dt ? (uint64_t) d * 1000 / dt : 0;
+	}
+#else
+	memset(snap->load, 0, sizeof(snap->load));
+#endif
+	for (k = 0; k < snap->n; k++) {
+		snap->pnum[k] = snap->st[k].xTaskNumber;
+		snap->prt[k] = snap->st[k].ulRunTimeCounter;
+	}
+	snap->pn = snap->n;
+	snap->ptot = tot;
+	return (snap->n);
+}
+
+#if TERMOUT == 1
+static const char st_chr[] = {'X', 'R', 'B', 'S', 'D', '?'};
+
+/**
+ * print_task_info
+ */
+void print_task_info(void)
+{
+	static struct task_snap snap;
+	uint8_t idx[TSKNFO_MAX_TASKS], t;
+	const TaskStatus_t *p;
+	int n, j;
+
+	if (0 > (n = task_snap(&snap))) {
+		msg(INF, "more than %d tasks\n", TSKNFO_MAX_TASKS);
+		return;
 	}
-	for (i = 0; i < V_TASK_LIST_BUFFER_SIZE; i++) {
-		if (*((unsigned char *) p_bf + i) == 0xEE) {
-			break;
+	for (int i = 0; i < n; i++) {
+		t = i;
+		for (j = i; j > 0; j--) {
+			if (snap.load[idx[j - 1]] > snap.load[t] ||
+			    (snap.load[idx[j - 1]] == snap.load[t] &&
+			     snap.st[idx[j - 1]].uxCurrentPriority >= snap.st[t].uxCurrentPriority)) {
+				break;
+			}
+			idx[j] = idx[j - 1];
 		}
+		idx[j] = t;
+	}
+	msg(INF, "%-*s Stat Prio StckFre TCBn   CPU\n", configMAX_TASK_NAME_LEN, "Name");
+	for (int i = 0; i < n; i++) {
+		p = &snap.st[idx[i]];
+		msg(INF, "%-*s    %c %4u %7u %4u %3u.%u%%\n", configMAX_TASK_NAME_LEN,
+		    p->pcTaskName, st_chr[p->eCurrentState <= eDeleted ? p->eCurrentState : 5],
+		    (unsigned int) p->uxCurrentPriority, (unsigned int) p->usStackHighWaterMark,
+		    (unsigned int) p->xTaskNumber, snap.load[idx[i]] / 10, snap.load[idx[i]] % 10);
 	}
-	msg(INF, ">>%d>\n", V_TASK_LIST_BUFFER_SIZE - i);
-	vTaskPrioritySet(NULL, prio);
-	vPortFree(p_bf);
 }
 #endif
+#endif
 
 #if configCHECK_FOR_STACK_OVERFLOW != 0
 /**
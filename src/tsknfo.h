@@ -19,12 +19,57 @@
 #ifndef TSKNFO_H
 #define TSKNFO_H
 
-#if TERMOUT == 1 && configUSE_TRACE_FACILITY == 1
+#if configUSE_TRACE_FACILITY == 1
+
+// Size of task snapshot (uxTaskGetSystemState() fails with more tasks).
+#ifndef TSKNFO_MAX_TASKS
+ #define TSKNFO_MAX_TASKS 16
+#endif
+
+#ifdef configRUN_TIME_COUNTER_TYPE
+typedef configRUN_TIME_COUNTER_TYPE tsk_rt_t;
+#else
+typedef uint32_t tsk_rt_t;
+#endif
+
+struct task_snap {
+	TaskStatus_t st[TSKNFO_MAX_TASKS];
+	// Name copies, st[].pcTaskName points here.
+	char nm[TSKNFO_MAX_TASKS][configMAX_TASK_NAME_LEN];
+	uint16_t load[TSKNFO_MAX_TASKS];
+	int n;
+	// Run time counters of previous snapshot.
+	UBaseType_t pnum[TSKNFO_MAX_TASKS];
+	tsk_rt_t prt[TSKNFO_MAX_TASKS];
+	int pn;
+	tsk_rt_t ptot;
+};
 
+/**
+ * task_snap
+ *
+ * Take snapshot of all tasks by uxTaskGetSystemState() and compute CPU
+ * load of every task (load, 0.1 % units) from run time counter deltas
+ * since previous task_snap() on same structure (since start for zeroed
+ * structure). Tasks are matched by xTaskNumber. Without
+ * configGENERATE_RUN_TIME_STATS loads are 0. Names are copied with
+ * scheduler suspended, snapshot stays valid if task is deleted.
+ *
+ * @snap: Snapshot (static or zeroed before first use).
+ *
+ * Returns: Number of tasks, -1 if there are more than TSKNFO_MAX_TASKS.
+ */
+int task_snap(struct task_snap *snap);
+
+#if TERMOUT == 1
 /**
  * print_task_info
+ *
+ * Print tasks sorted by CPU load (since previous call) and priority:
+ * name, state, priority, free stack (words), task number, load.
  */
 void print_task_info(void);
 #endif
+#endif
 
 #endif
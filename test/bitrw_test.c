@@ -0,0 +1,223 @@
+/*
+ * bitrw_test.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Randomized bit stream tests: bitrw_test [cases [seed]]
+ *
+ * Random fields (1 - BITRW_MAX_BITS bits) are written by bitwriter in both
+ * bit orders, output is compared with bitwise model and read back by
+ * bitreader (read or peek and skip). Writer with short buffer must report
+ * overflow and keep bytes after buffer.
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "bitrw.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define FIELDS 64
+#define OUT_BYTES (FIELDS * BITRW_MAX_BITS / 8 + 1)
+#define GUARD 0x5A
+
+static int len[FIELDS];
+static uint64_t val[FIELDS];
+static uint8_t out[OUT_BYTES + 8], ref[OUT_BYTES];
+
+static int test_rw(long n);
+static int test_ovf(long n);
+static int gen(void);
+static void ref_write(enum bitrw_order ord, int nf);
+static uint64_t rnd64(void);
+static int fail(const char *what, enum bitrw_order ord, int nf, int f);
+
+int main(int argc, char **argv)
+{
+	long n = 100000;
+
+	if (argc > 1) {
+		n = strtol(argv[1], NULL, 0);
+	}
+	srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+	if (test_rw(n) || test_ovf(n / 4)) {
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * test_rw
+ */
+static int test_rw(long n)
+{
+	struct bitwriter bw;
+	struct bitreader br;
+	enum bitrw_order ord;
+	int nf, bits, nb, pos;
+	uint64_t v;
+
+	for (long i = 0; i < n; i++) {
+		ord = rand() & 1 ? BITRW_MSB : BITRW_LSB;
+		nf = gen();
+		bits = 0;
+		for (int k = 0; k < nf; k++) {
+			bits += len[k];
+		}
+		nb = (bits + 7) / 8;
+		memset(out, GUARD, sizeof(out));
+		init_bitwriter(&bw, out, nb, ord);
+		for (int k = 0; k < nf; k++) {
+			bw_write(&bw, len[k], val[k] | (rnd64() << len[k]));
+		}
+		if (bw_finish(&bw) != nb) {
+			return (fail("writer length", ord, nf, -1));
+		}
+		ref_write(ord, nf);
+		if (memcmp(out, ref, nb) || out[nb] != GUARD) {
+			return (fail("writer output", ord, nf, -1));
+		}
+		init_bitreader(&br, out, nb, ord);
+		pos = 0;
+		for (int k = 0; k < nf; k++) {
+			if (rand() & 1) {
+				v = br_read(&br, len[k]);
+			} else {
+				v = br_peek(&br, len[k]);
+				br_skip(&br, len[k]);
+			}
+			pos += len[k];
+			if (v != val[k] || br_pos(&br) != pos) {
+				return (fail("reader", ord, nf, k));
+			}
+		}
+		if (br_ovf(&br)) {
+			return (fail("reader overflow at end", ord, nf, -1));
+		}
+		if (br_read(&br, 8 * nb - bits + 1) || !br_ovf(&br)) {
+			return (fail("reader past end", ord, nf, -1));
+		}
+	}
+	printf("bitrw: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * test_ovf
+ *
+ * Output buffer shorter than stream by 1 - 8 bytes.
+ */
+static int test_ovf(long n)
+{
+	struct bitwriter bw;
+	enum bitrw_order ord;
+	int nf, bits, nb, sz;
+
+	for (long i = 0; i < n; i++) {
+		ord = rand() & 1 ? BITRW_MSB : BITRW_LSB;
+		do {
+			nf = gen();
+			bits = 0;
+			for (int k = 0; k < nf; k++) {
+				bits += len[k];
+			}
+			nb = (bits + 7) / 8;
+		} while (nb < 2);
+		sz = nb - 1 - rand() % (nb - 1 < 8 ? nb - 1 : 8);
+		memset(out, GUARD, sizeof(out));
+		init_bitwriter(&bw, out, sz, ord);
+		for (int k = 0; k < nf; k++) {
+			bw_write(&bw, len[k], val[k]);
+		}
+		if (bw_finish(&bw) != -1) {
+			return (fail("overflow not reported", ord, nf, -1));
+		}
+		ref_write(ord, nf);
+		if (memcmp(out, ref, sz)) {
+			return (fail("overflow output", ord, nf, -1));
+		}
+		for (int k = sz; k < (int) sizeof(out); k++) {
+			if (out[k] != GUARD) {
+				return (fail("write past buffer", ord, nf, -1));
+			}
+		}
+	}
+	printf("bitrw overflow: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * gen
+ *
+ * Random fields, half of streams use short fields only.
+ *
+ * Returns: Number of fields.
+ */
+static int gen(void)
+{
+	int nf = 1 + rand() % FIELDS, mx = rand() & 1 ? 8 : BITRW_MAX_BITS;
+
+	for (int k = 0; k < nf; k++) {
+		len[k] = 1 + rand() % mx;
+		val[k] = rnd64() & (((uint64_t) 1 << len[k]) - 1);
+	}
+	return (nf);
+}
+
+/**
+ * ref_write
+ *
+ * Bitwise model, stream bit i is bit i % 8 (LSB) or 7 - i % 8 (MSB) of
+ * byte i / 8.
+ */
+static void ref_write(enum bitrw_order ord, int nf)
+{
+	int pos = 0, b;
+
+	memset(ref, 0, sizeof(ref));
+	for (int k = 0; k < nf; k++) {
+		for (int j = 0; j < len[k]; j++, pos++) {
+			b = ord == BITRW_LSB ? (val[k] >> j) & 1 : (val[k] >> (len[k] - 1 - j)) & 1;
+			ref[pos / 8] |= b << (ord == BITRW_LSB ? pos % 8 : 7 - pos % 8);
+		}
+	}
+}
+
+/**
+ * rnd64
+ */
+static uint64_t rnd64(void)
+{
+	uint64_t v = 0;
+
+	for (int i = 0; i < 4; i++) {
+		v = (v << 16) | (rand() & 0xFFFF);
+	}
+	return (v);
+}
+
+/**
+ * fail
+ */
+static int fail(const char *what, enum bitrw_order ord, int nf, int f)
+{
+	printf("bitrw %s: order=%s fields=%d field=%d\n", what, ord == BITRW_LSB ? "lsb" : "msb",
+	       nf, f);
+	return (1);
+}
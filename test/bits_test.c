@@ -0,0 +1,324 @@
+/*
+ * bits_test.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Randomized bit field tests: bits_test [cases [seed]]
+ *
+ * extract_bits() is compared with baseline, insert_bits() and encode_bits()
+ * are checked by round trip through extract_bits() and decode_bits().
+ *
+ * Host must be little endian, bit k of output is then bit k of its bytes
+ * for every out_t.
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "tools.h"
+#include "bits_ref.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define IN_BYTES 64
+#define MAX_LEN 200
+#define OUT_BYTES 64
+#define GUARD 0x5A
+#define FRM_BYTES 64
+#define FIELDS 32
+
+static const enum uint_typename typ[] = {UI8_TYPE, UI16_TYPE, UI32_TYPE, UI64_TYPE};
+
+static uint64_t in[IN_BYTES / 8];
+static uint64_t out[OUT_BYTES / 8 + 1], ref[OUT_BYTES / 8 + 1];
+
+static int test_extract(long n);
+static int test_insert(long n);
+static int test_schema(long n);
+static int get_bit(const void *p, int pos);
+static int get_fbit(const void *p, int pos, enum bits_order ord);
+static int fail(const char *what, int le, int in_t, int out_t, int st, int len);
+
+int main(int argc, char **argv)
+{
+	long n = 200000;
+
+	if (argc > 1) {
+		n = strtol(argv[1], NULL, 0);
+	}
+	srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+	if (test_extract(n) || test_insert(n) || test_schema(n / 4)) {
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * test_extract
+ *
+ * Every field is checked bit by bit, and compared with baseline
+ * implementation except where baseline is known wrong: in_t 8/16 with
+ * out_t 64 sign-extended bytes with top bit set into higher bits. Baseline
+ * could also write zero words past ceil(len / out_t), only needed words are
+ * compared and new implementation must leave rest untouched.
+ */
+static int test_extract(long n)
+{
+	int in_t, out_t, st, len, le, nb;
+
+	for (long i = 0; i < n; i++) {
+		in_t = typ[rand() % 4];
+		out_t = typ[rand() % 4];
+		len = 1 + rand() % MAX_LEN;
+		st = rand() % (IN_BYTES * 8 - len + 1);
+		le = rand() & 1;
+		nb = (len + out_t - 1) / out_t * out_t / 8;
+		for (int k = 0; k < IN_BYTES; k++) {
+			*((uint8_t *) in + k) = rand();
+		}
+		memset(out, GUARD, sizeof(out));
+		memset(ref, GUARD, sizeof(ref));
+		if (le) {
+			extract_bits_le(in, in_t, out, out_t, st, len);
+			ref_extract_bits_le(in, in_t, ref, out_t, st, len);
+		} else {
+			extract_bits(in, in_t, out, out_t, st, len);
+			ref_extract_bits(in, in_t, ref, out_t, st, len);
+		}
+		for (int k = 0; k < nb * 8; k++) {
+			if (get_bit(out, k) != (k < len ? get_bit(in, st + k) : 0)) {
+				return (fail("bit", le, in_t, out_t, st, len));
+			}
+		}
+		for (int k = nb; k < (int) sizeof(out); k++) {
+			if (*((uint8_t *) out + k) != GUARD) {
+				return (fail("write past output", le, in_t, out_t, st, len));
+			}
+		}
+		if (out_t == UI64_TYPE && in_t < UI32_TYPE) {
+			continue;
+		}
+		if (memcmp(out, ref, nb)) {
+			return (fail("baseline", le, in_t, out_t, st, len));
+		}
+	}
+	printf("extract_bits: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * test_insert
+ *
+ * Inserted bits must read back by extract function of same endianness with
+ * swapped types, all other bits of area must be preserved.
+ */
+static int test_insert(long n)
+{
+	static uint64_t val[OUT_BYTES / 8];
+	int in_t, out_t, st, len, le;
+
+	for (long i = 0; i < n; i++) {
+		in_t = typ[rand() % 4];
+		out_t = typ[rand() % 4];
+		len = 1 + rand() % MAX_LEN;
+		st = rand() % (IN_BYTES * 8 - len + 1);
+		le = rand() & 1;
+		for (int k = 0; k < IN_BYTES; k++) {
+			*((uint8_t *) in + k) = rand();
+			*((uint8_t *) val + k) = rand();
+		}
+		memcpy(ref, in, IN_BYTES);
+		if (le) {
+			insert_bits_le(in, out_t, val, in_t, st, len);
+		} else {
+			insert_bits(in, out_t, val, in_t, st, len);
+		}
+		for (int k = 0; k < IN_BYTES * 8; k++) {
+			if (get_bit(in, k) != (k >= st && k < st + len ? get_bit(val, k - st) :
+			                                                  get_bit(ref, k))) {
+				return (fail("insert", le, in_t, out_t, st, len));
+			}
+		}
+		memset(out, 0, sizeof(out));
+		if (le) {
+			extract_bits_le(in, out_t, out, in_t, st, len);
+		} else {
+			extract_bits(in, out_t, out, in_t, st, len);
+		}
+		for (int k = 0; k < len; k++) {
+			if (get_bit(out, k) != get_bit(val, k)) {
+				return (fail("insert round trip", le, in_t, out_t, st, len));
+			}
+		}
+	}
+	printf("insert_bits: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * test_schema
+ *
+ * Random schema with non-overlapping fields (half of cases densely packed
+ * from bit 0, so windows are fully covered) in both bit orders. Field bits
+ * of encoded frame are compared with bitwise model, other bits must be
+ * kept. Decoded members must equal encoded ones truncated to field length
+ * (and sign extended for BITS_SIGNED).
+ */
+static int test_schema(long n)
+{
+	static struct bits_field fld[FIELDS];
+	static struct bits_op op[FIELDS];
+	static uint8_t frm[FRM_BYTES + 8], frm0[FRM_BYTES + 8], cov[FRM_BYTES * 8];
+	static uint64_t val[FIELDS], dec[FIELDS];
+	struct bits_schema sch;
+	enum bits_order ord;
+	int nf, in_sz, pos;
+
+	for (long i = 0; i < n; i++) {
+		ord = i & 2 ? BITS_MSB : BITS_LSB;
+		nf = 1 + rand() % FIELDS;
+		in_sz = 1 + rand() % FRM_BYTES;
+		memset(cov, 0, sizeof(cov));
+		pos = 0;
+		for (int k = 0; k < nf; k++) {
+			struct bits_field *f = fld + k;
+			int tr;
+
+			f->sz = 1 << rand() % 4;
+			f->len = 1 + rand() % (8 * f->sz);
+			if (f->len > 8 * in_sz - pos) {
+				f->len = 8 * in_sz - pos;
+			}
+			if (f->len < 1) {
+				nf = k;
+				break;
+			}
+			if (i & 1) {
+				f->start = pos;
+				pos += f->len;
+			} else {
+				for (tr = 0; tr < 20; tr++) {
+					f->start = rand() % (8 * in_sz - f->len + 1);
+					if (!memchr(cov + f->start, 1, f->len)) {
+						break;
+					}
+				}
+				if (tr == 20) {
+					nf = k;
+					break;
+				}
+			}
+			memset(cov + f->start, 1, f->len);
+			f->flags = (rand() & 1) ? BITS_SIGNED : 0;
+			f->off = 8 * k;
+		}
+		if (!nf) {
+			continue;
+		}
+		init_bits_schema(&sch, fld, op, nf, in_sz, ord);
+		for (int k = 0; k < (int) sizeof(frm); k++) {
+			frm[k] = rand();
+		}
+		for (int k = 0; k < (int) sizeof(val); k++) {
+			*((uint8_t *) val + k) = rand();
+		}
+		memcpy(frm0, frm, sizeof(frm));
+		encode_bits(&sch, val, frm);
+		for (int k = 0; k < (int) sizeof(frm) * 8; k++) {
+			if (k >= 8 * in_sz || !cov[k]) {
+				if (get_fbit(frm, k, ord) != get_fbit(frm0, k, ord)) {
+					printf("encode keep mismatch: ord=%d fields=%d in_sz=%d bit=%d\n",
+					       ord, nf, in_sz, k);
+					return (1);
+				}
+			}
+		}
+		for (int k = 0; k < nf; k++) {
+			const struct bits_field *f = fld + k;
+
+			for (int j = 0; j < f->len; j++) {
+				if (get_fbit(frm, f->start + j, ord) !=
+				    get_bit((uint8_t *) val + f->off, ord == BITS_LSB ? j : f->len - 1 - j)) {
+					printf("encode placement mismatch: ord=%d start=%d len=%d bit=%d\n",
+					       ord, f->start, f->len, j);
+					return (1);
+				}
+			}
+		}
+		memset(dec, GUARD, sizeof(dec));
+		decode_bits(&sch, frm, dec);
+		for (int k = 0; k < nf; k++) {
+			const struct bits_field *f = fld + k;
+			uint64_t v = 0, d = 0;
+
+			memcpy(&v, (uint8_t *) val + f->off, f->sz);
+			memcpy(&d, (uint8_t *) dec + f->off, f->sz);
+			if (f->len < 64) {
+				v &= ((uint64_t) 1 << f->len) - 1;
+				if ((f->flags & BITS_SIGNED) && (v >> (f->len - 1) & 1)) {
+					v |= ~(uint64_t) 0 << f->len;
+				}
+			}
+			if (f->sz < 8) {
+				v &= ((uint64_t) 1 << 8 * f->sz) - 1;
+			}
+			if (d != v) {
+				printf("encode round trip mismatch: ord=%d fields=%d in_sz=%d start=%d len=%d\n",
+				       ord, nf, in_sz, f->start, f->len);
+				return (1);
+			}
+		}
+	}
+	printf("encode_bits: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * get_bit
+ */
+static int get_bit(const void *p, int pos)
+{
+	return ((*((const uint8_t *) p + pos / 8) >> pos % 8) & 1);
+}
+
+/**
+ * get_fbit
+ *
+ * Frame bit in schema order.
+ */
+static int get_fbit(const void *p, int pos, enum bits_order ord)
+{
+	return (get_bit(p, ord == BITS_LSB ? pos : pos / 8 * 8 + 7 - pos % 8));
+}
+
+/**
+ * fail
+ */
+static int fail(const char *what, int le, int in_t, int out_t, int st, int len)
+{
+	printf("%s mismatch: le=%d in_t=%d out_t=%d start=%d len=%d\n", what, le, in_t,
+	       out_t, st, len);
+	return (1);
+}
+
+void crit_err_exit(enum crit_err err)
+{
+	printf("crit_err_exit(%d)\n", err);
+	exit(1);
+}
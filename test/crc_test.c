@@ -0,0 +1,448 @@
+/*
+ * crc_test.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Randomized CRC tests: crc_test [cases [seed]]
+ *
+ * Every preset is compared with bitwise reference (ref_crc(), written from
+ * model parameters, no code shared with crc.c) at random lengths and
+ * alignments. Tier of all presets is given by CRC_*_SLICE of the build,
+ * CRC_CLMUL build checks PCLMULQDQ folding too. Last lines are throughput
+ * of each preset with its table size.
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "crc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BUF_SZ 4096
+#define MAX_LEN 600
+#define MAX_SEG 6
+#define PAR_SZ (1 << 20)
+#define PAR_THR 8
+#define BENCH_SZ 65536
+#define BENCH_ROUNDS 64
+
+static const struct crc_model *const mdl[] = {
+	&crc8_smbus, &crc16_arc, &crc16_modbus, &crc16_ibm3740, &crc16_xmodem, &crc32, &crc32c
+};
+
+#define MDL_CNT ((int) (sizeof(mdl) / sizeof(mdl[0])))
+
+static uint8_t buf[BUF_SZ + 8], lin[BUF_SZ];
+
+static int test_check(void);
+static int test_rand(long n);
+static int test_legacy(long n);
+static int test_iov(long n);
+static int test_ring(long n);
+static int test_combine(long n);
+static int test_par(void);
+#if CRC_CLMUL == 1
+static int test_clmul(long n);
+#endif
+static uint32_t ref_crc(const struct crc_model *m, const uint8_t *p, int len);
+static uint32_t ref_upd(const struct crc_model *m, uint32_t reg, const uint8_t *p, int len);
+static uint32_t refl(uint32_t v, int w);
+static void bench(void);
+static double now(void);
+static void rnd_fill(uint8_t *p, int len);
+static int fail(const struct crc_model *m, const char *what, int ofs, int len, uint32_t got,
+                uint32_t exp);
+
+int main(int argc, char **argv)
+{
+	long n = 20000;
+
+	if (argc > 1) {
+		n = strtol(argv[1], NULL, 0);
+	}
+	srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+	if (test_check() || test_rand(n) || test_legacy(n) || test_iov(n) ||
+	    test_ring(n) || test_combine(n) || test_par()) {
+		return (1);
+	}
+#if CRC_CLMUL == 1
+	if (test_clmul(n)) {
+		return (1);
+	}
+#endif
+	bench();
+	return (0);
+}
+
+/**
+ * test_check
+ *
+ * Reference and crc_calc() must give check value of model.
+ */
+static int test_check(void)
+{
+	static const uint8_t chk[] = "123456789";
+	uint32_t c;
+
+	for (int i = 0; i < MDL_CNT; i++) {
+		if ((c = ref_crc(mdl[i], chk, 9)) != mdl[i]->check) {
+			return (fail(mdl[i], "reference check", 0, 9, c, mdl[i]->check));
+		}
+		if ((c = crc_calc(mdl[i], chk, 9)) != mdl[i]->check) {
+			return (fail(mdl[i], "check", 0, 9, c, mdl[i]->check));
+		}
+	}
+	return (0);
+}
+
+/**
+ * test_rand
+ *
+ * crc_calc() and crc_update() split at random point.
+ */
+static int test_rand(long n)
+{
+	const struct crc_model *m;
+	uint32_t r, c;
+	int ofs, len, k;
+
+	for (long i = 0; i < n; i++) {
+		m = mdl[i % MDL_CNT];
+		ofs = rand() % 8;
+		len = rand() % MAX_LEN;
+		k = len ? rand() % (len + 1) : 0;
+		rnd_fill(buf + ofs, len);
+		r = ref_crc(m, buf + ofs, len);
+		if ((c = crc_calc(m, buf + ofs, len)) != r) {
+			return (fail(m, "crc_calc", ofs, len, c, r));
+		}
+		c = crc_update(m, m->init, buf + ofs, k);
+		c = crc_update(m, c, buf + ofs + k, len - k) ^ m->xorout;
+		if (c != r) {
+			return (fail(m, "crc_update split", ofs, len, c, r));
+		}
+	}
+	printf("crc: %ld cases, slice 16/ccit/8/32/32c %d/%d/%d/%d/%d\n", n, CRC_16_SLICE,
+	       CRC_CCIT_SLICE, CRC_8_SLICE, CRC_32_SLICE, CRC_32C_SLICE);
+	return (0);
+}
+
+/**
+ * test_legacy
+ *
+ * crc_16() and crc_ccit() are presets of engine.
+ */
+static int test_legacy(long n)
+{
+	uint32_t r, c;
+	int ofs, len;
+
+	for (long i = 0; i < n; i++) {
+		ofs = rand() % 8;
+		len = rand() % MAX_LEN;
+		rnd_fill(buf + ofs, len);
+		r = ref_crc(&crc16_arc, buf + ofs, len);
+		if ((c = crc_16(INIT_CRC_16, buf + ofs, len)) != r) {
+			return (fail(&crc16_arc, "crc_16", ofs, len, c, r));
+		}
+		r = ref_crc(&crc16_modbus, buf + ofs, len);
+		if ((c = crc_16(INIT_CRC_16_MODB, buf + ofs, len)) != r) {
+			return (fail(&crc16_modbus, "crc_16", ofs, len, c, r));
+		}
+		r = ref_crc(&crc16_ibm3740, buf + ofs, len);
+		if ((c = crc_ccit(INIT_CRC_CCITT, buf + ofs, len)) != r) {
+			return (fail(&crc16_ibm3740, "crc_ccit", ofs, len, c, r));
+		}
+	}
+	return (0);
+}
+
+/**
+ * test_iov
+ *
+ * Segments of random length (zero too) and alignment, apart in buffer.
+ */
+static int test_iov(long n)
+{
+	const struct crc_model *m;
+	struct crc_seg seg[MAX_SEG];
+	uint32_t r, c;
+	int cnt, len;
+
+	for (long i = 0; i < n; i++) {
+		m = mdl[i % MDL_CNT];
+		cnt = 1 + rand() % MAX_SEG;
+		len = 0;
+		for (int k = 0; k < cnt; k++) {
+			seg[k].len = rand() % 4 ? rand() % (MAX_LEN / MAX_SEG) : 0;
+			seg[k].p = buf + k * (BUF_SZ / MAX_SEG) + rand() % 8;
+			rnd_fill((uint8_t *) seg[k].p, seg[k].len);
+			memcpy(lin + len, seg[k].p, seg[k].len);
+			len += seg[k].len;
+		}
+		r = ref_crc(m, lin, len);
+		if ((c = crc_update_iov(m, m->init, seg, cnt) ^ m->xorout) != r) {
+			return (fail(m, "crc_update_iov", 0, len, c, r));
+		}
+	}
+	return (0);
+}
+
+/**
+ * test_ring
+ *
+ * Data at random offset of ring of random size, wrapped or not.
+ */
+static int test_ring(long n)
+{
+	const struct crc_model *m;
+	uint32_t r, c;
+	int sz, ofs, len, al;
+
+	for (long i = 0; i < n; i++) {
+		m = mdl[i % MDL_CNT];
+		sz = 1 + rand() % MAX_LEN;
+		ofs = rand() % sz;
+		len = rand() % (sz + 1);
+		al = rand() % 8;
+		rnd_fill(buf + al, sz);
+		for (int k = 0; k < len; k++) {
+			lin[k] = buf[al + (ofs + k) % sz];
+		}
+		r = ref_crc(m, lin, len);
+		if ((c = crc_update_ring(m, m->init, buf + al, sz, ofs, len) ^ m->xorout) != r) {
+			return (fail(m, "crc_update_ring", ofs, len, c, r));
+		}
+	}
+	return (0);
+}
+
+/**
+ * test_combine
+ *
+ * crc_combine() of random split, crc_16_combine() and crc_ccit_combine().
+ */
+static int test_combine(long n)
+{
+	const struct crc_model *m;
+	uint32_t r, c;
+	int ofs, len, k;
+
+	for (long i = 0; i < n; i++) {
+		m = mdl[i % MDL_CNT];
+		ofs = rand() % 8;
+		len = rand() % MAX_LEN;
+		k = len ? rand() % (len + 1) : 0;
+		rnd_fill(buf + ofs, len);
+		r = ref_crc(m, buf + ofs, len);
+		c = crc_combine(m, crc_calc(m, buf + ofs, k), crc_calc(m, buf + ofs + k, len - k),
+		                len - k);
+		if (c != r) {
+			return (fail(m, "crc_combine", k, len, c, r));
+		}
+		if (m == &crc16_arc) {
+			c = crc_16_combine(crc_16(INIT_CRC_16, buf + ofs, k),
+			                   crc_16(INIT_CRC_16, buf + ofs + k, len - k), len - k);
+			if (c != r) {
+				return (fail(m, "crc_16_combine", k, len, c, r));
+			}
+		} else if (m == &crc16_ibm3740) {
+			c = crc_ccit_combine(crc_ccit(INIT_CRC_CCITT, buf + ofs, k),
+			                     crc_ccit(INIT_CRC_CCITT, buf + ofs + k, len - k), len - k);
+			if (c != r) {
+				return (fail(m, "crc_ccit_combine", k, len, c, r));
+			}
+		}
+	}
+	return (0);
+}
+
+/**
+ * test_par
+ *
+ * crc_par() with 1 - PAR_THR threads (chunks of at least 64 KiB) against
+ * crc_calc() checked above.
+ */
+static int test_par(void)
+{
+	static uint8_t b[PAR_SZ + 8];
+	const struct crc_model *m;
+	uint32_t r, c;
+	int ofs, len;
+
+	for (int i = 0; i < MDL_CNT * 4; i++) {
+		m = mdl[i % MDL_CNT];
+		ofs = rand() % 8;
+		len = PAR_SZ - rand() % 4096;
+		rnd_fill(b + ofs, len);
+		r = crc_calc(m, b + ofs, len);
+		if ((c = crc_par(m, b + ofs, len, 1 + i % PAR_THR)) != r) {
+			return (fail(m, "crc_par", ofs, len, c, r));
+		}
+	}
+	return (0);
+}
+
+#if CRC_CLMUL == 1
+/**
+ * test_clmul
+ *
+ * crc_16_clmul() and crc_ccit_clmul() with random register value at
+ * random lengths (table code below 64 bytes) and alignments.
+ */
+static int test_clmul(long n)
+{
+	uint32_t r, c;
+	uint16_t ini;
+	int ofs, len;
+
+	if (!crc_clmul_ok()) {
+		printf("crc clmul: CPU lacks PCLMULQDQ, not tested\n");
+		return (0);
+	}
+	for (long i = 0; i < n; i++) {
+		ofs = rand() % 16;
+		len = rand() % 8 ? rand() % 512 : rand() % (BUF_SZ - 8);
+		ini = rand();
+		rnd_fill(buf + ofs, len);
+		r = ref_upd(&crc16_arc, ini, buf + ofs, len);
+		if ((c = crc_16_clmul(ini, buf + ofs, len)) != r) {
+			return (fail(&crc16_arc, "crc_16_clmul", ofs, len, c, r));
+		}
+		r = ref_upd(&crc16_ibm3740, ini, buf + ofs, len);
+		if ((c = crc_ccit_clmul(ini, buf + ofs, len)) != r) {
+			return (fail(&crc16_ibm3740, "crc_ccit_clmul", ofs, len, c, r));
+		}
+	}
+	printf("crc clmul: %ld cases\n", n);
+	return (0);
+}
+#endif
+
+/**
+ * ref_crc
+ */
+static uint32_t ref_crc(const struct crc_model *m, const uint8_t *p, int len)
+{
+	return (ref_upd(m, m->init, p, len) ^ m->xorout);
+}
+
+/**
+ * ref_upd
+ *
+ * Bit by bit in normal order, reflected models reflect input bytes and
+ * register (as crc_update()).
+ */
+static uint32_t ref_upd(const struct crc_model *m, uint32_t reg, const uint8_t *p, int len)
+{
+	uint32_t top = (uint32_t) 1 << (m->width - 1), msk = top | (top - 1), b;
+
+	if (m->refl) {
+		reg = refl(reg, m->width);
+	}
+	for (int i = 0; i < len; i++) {
+		for (int k = 0; k < 8; k++) {
+			b = m->refl ? (p[i] >> k) & 1 : (p[i] >> (7 - k)) & 1;
+			b ^= (reg & top) ? 1 : 0;
+			reg = (reg << 1) & msk;
+			if (b) {
+				reg ^= m->poly;
+			}
+		}
+	}
+	return (m->refl ? refl(reg, m->width) : reg);
+}
+
+/**
+ * refl
+ */
+static uint32_t refl(uint32_t v, int w)
+{
+	uint32_t r = 0;
+
+	for (int k = 0; k < w; k++) {
+		r = (r << 1) | ((v >> k) & 1);
+	}
+	return (r);
+}
+
+/**
+ * bench
+ */
+static void bench(void)
+{
+	static uint8_t b[BENCH_SZ] __attribute__((aligned(4)));
+	volatile uint32_t sink;
+	uint32_t c;
+	double t;
+
+	rnd_fill(b, BENCH_SZ);
+	for (int i = 0; i < MDL_CNT; i++) {
+		c = mdl[i]->init;
+		t = now();
+		for (int k = 0; k < BENCH_ROUNDS; k++) {
+			c = crc_update(mdl[i], c, b, BENCH_SZ);
+		}
+		t = now() - t;
+		sink = c;
+		printf("crc bench: %-15s table %5d B %6.3f ns/B\n", mdl[i]->nm,
+		       crc_tbl_size(mdl[i]), t / BENCH_ROUNDS / BENCH_SZ);
+	}
+	(void) sink;
+}
+
+/**
+ * now
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+/**
+ * rnd_fill
+ */
+static void rnd_fill(uint8_t *p, int len)
+{
+	while (len--) {
+		*p++ = rand();
+	}
+}
+
+/**
+ * fail
+ */
+static int fail(const struct crc_model *m, const char *what, int ofs, int len, uint32_t got,
+                uint32_t exp)
+{
+	printf("%s %s: ofs=%d len=%d got=%08X exp=%08X\n", m->nm, what, ofs, len,
+	       (unsigned int) got, (unsigned int) exp);
+	return (1);
+}
+
+void crit_err_exit(enum crit_err err)
+{
+	printf("crit_err_exit(%d)\n", err);
+	exit(1);
+}
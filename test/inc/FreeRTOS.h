@@ -0,0 +1,26 @@
+/*
+ * FreeRTOS.h
+ *
+ * Host stand-in for the kernel headers (types and configuration only).
+ */
+
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef uint32_t TickType_t;
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t StackType_t;
+
+#define portMAX_DELAY 0xFFFFFFFFU
+#define pdPASS 1
+#define pdFAIL 0
+#define pdTRUE 1
+#define pdFALSE 0
+#define errQUEUE_FULL 0
+#define configMAX_TASK_NAME_LEN 16
+
+#endif
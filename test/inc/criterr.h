@@ -0,0 +1,18 @@
+/*
+ * criterr.h
+ *
+ * Host stand-in, crit_err_exit() is implemented by test program.
+ */
+
+#ifndef CRITERR_H
+#define CRITERR_H
+
+enum crit_err {
+	BAD_PARAMETER = 1,
+	MALLOC_ERROR,
+	APP_ERROR
+};
+
+void crit_err_exit(enum crit_err err) __attribute__((noreturn));
+
+#endif
@@ -0,0 +1,13 @@
+/*
+ * fmalloc.h
+ *
+ * Host stand-in, allocator is implemented by test program.
+ */
+
+#ifndef FMALLOC_H
+#define FMALLOC_H
+
+void *pvPortMalloc(size_t size);
+void vPortFree(void *p);
+
+#endif
@@ -0,0 +1,15 @@
+/*
+ * gentyp.h
+ *
+ * Host stand-in.
+ */
+
+#ifndef GENTYP_H
+#define GENTYP_H
+
+typedef int boolean_t;
+
+#define TRUE 1
+#define FALSE 0
+
+#endif
@@ -0,0 +1,12 @@
+/*
+ * hwerr.h
+ *
+ * Host stand-in.
+ */
+
+#ifndef HWERR_H
+#define HWERR_H
+
+#include <errno.h>
+
+#endif
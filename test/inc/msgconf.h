@@ -0,0 +1,19 @@
+/*
+ * msgconf.h
+ *
+ * Host stand-in, msg() is implemented by test program.
+ */
+
+#ifndef MSGCONF_H
+#define MSGCONF_H
+
+#include "tout.h"
+
+enum msg_type {
+	INF,
+	WARNING
+};
+
+void msg(enum msg_type type, const char *fmt, ...);
+
+#endif
@@ -0,0 +1,17 @@
+/*
+ * queue.h
+ *
+ * Host stand-in, functions are implemented by test program.
+ */
+
+#ifndef INC_QUEUE_H
+#define INC_QUEUE_H
+
+typedef void *QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t isz);
+BaseType_t xQueueSend(QueueHandle_t q, const void *p, TickType_t tm);
+BaseType_t xQueuePeek(QueueHandle_t q, void *p, TickType_t tm);
+BaseType_t xQueueReceive(QueueHandle_t q, void *p, TickType_t tm);
+
+#endif
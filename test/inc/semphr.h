@@ -0,0 +1,18 @@
+/*
+ * semphr.h
+ *
+ * Host stand-in, functions are implemented by test program.
+ */
+
+#ifndef SEMAPHORE_H
+#define SEMAPHORE_H
+
+#include "queue.h"
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t tm);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s);
+
+#endif
@@ -0,0 +1,36 @@
+/*
+ * sysconf.h
+ *
+ * Configuration of host tests.
+ */
+
+#ifndef SYSCONF_H
+#define SYSCONF_H
+
+#define TERMOUT 1
+#define TERMOUT_BUFFER_SIZE 1024
+#define TERMOUT_MAX_ROW_LENGTH 80
+#define TERMOUT_MAX_ROWS_IN_QUEUE 16
+#define TERMOUT_STACK_SIZE 0
+#define TERMOUT_TASK_PRIO 1
+#define TERMOUT_SEND_CLS_ON_START 0
+
+#define TERMIN 1
+#define TERMIN_MAX_ROW_LENGTH 32
+#define TERMIN_STACK_SIZE 0
+#define TERMIN_TASK_PRIO 1
+#define TERMIN_START_ECHO_ON 1
+#define TERMIO_STACK_SIZE 0
+#define TERMIO_TASK_PRIO 1
+
+#define TERMIN_STATS 1
+#define TERMIN_STATS_CNT() test_cnt()
+unsigned int test_cnt(void);
+
+#define TOOLS_EXTRACT_BITS 1
+#define TOOLS_EXTRACT_BITS_LE 1
+#define TOOLS_INSERT_BITS 1
+#define TOOLS_INSERT_BITS_LE 1
+#define TOOLS_BITS_SCHEMA 1
+
+#endif
@@ -0,0 +1,61 @@
+/*
+ * task.h
+ *
+ * Host stand-in, functions are implemented by test program.
+ */
+
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+typedef void *TaskHandle_t;
+typedef enum {
+	eRunning,
+	eReady,
+	eBlocked,
+	eSuspended,
+	eDeleted,
+	eInvalid
+} eTaskState;
+typedef enum {
+	eNoAction,
+	eSetBits,
+	eIncrement,
+	eSetValueWithOverwrite,
+	eSetValueWithoutOverwrite
+} eNotifyAction;
+
+typedef struct xTASK_STATUS {
+	TaskHandle_t xHandle;
+	const char *pcTaskName;
+	UBaseType_t xTaskNumber;
+	eTaskState eCurrentState;
+	UBaseType_t uxCurrentPriority;
+	UBaseType_t uxBasePriority;
+	uint32_t ulRunTimeCounter;
+	StackType_t *pxStackBase;
+	StackType_t *pxEndOfStack;
+	uint16_t usStackHighWaterMark;
+} TaskStatus_t;
+
+#define taskSCHEDULER_SUSPENDED 0
+#define taskSCHEDULER_NOT_STARTED 1
+#define taskSCHEDULER_RUNNING 2
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+BaseType_t xTaskCreate(void (*fn)(void *), const char *nm, uint32_t ssz, void *p,
+                       UBaseType_t prio, TaskHandle_t *hndl);
+void vTaskDelay(TickType_t tm);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+BaseType_t xTaskGetSchedulerState(void);
+void vTaskSuspendAll(void);
+BaseType_t xTaskResumeAll(void);
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *st, UBaseType_t n, uint32_t *rt);
+BaseType_t xTaskNotify(TaskHandle_t hndl, uint32_t v, eNotifyAction a);
+BaseType_t xTaskNotifyFromISR(TaskHandle_t hndl, uint32_t v, eNotifyAction a,
+                              BaseType_t *p_woken);
+BaseType_t xTaskNotifyWait(uint32_t clr_in, uint32_t clr_out, uint32_t *p_v,
+                           TickType_t tm);
+
+#endif
@@ -0,0 +1,46 @@
+/*
+ * mtrack_heap.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Kernel heap of mtrack_test (separate unit, --wrap replaces only
+ * references to undefined symbols).
+ */
+
+#include <FreeRTOS.h>
+#include "fmalloc.h"
+#include <stdlib.h>
+
+int nheap;
+
+void *pvPortMalloc(size_t size)
+{
+	void *p = malloc(size);
+
+	if (p) {
+		nheap++;
+	}
+	return (p);
+}
+
+void vPortFree(void *p)
+{
+	if (p) {
+		nheap--;
+	}
+	free(p);
+}
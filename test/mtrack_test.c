@@ -0,0 +1,345 @@
+/*
+ * mtrack_test.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Allocation tracking test: mtrack_test [cases [seed]]
+ *
+ * Random allocations and frees from SITES call sites and two tasks go
+ * through wrapped pvPortMalloc()/vPortFree(), mtrack_sites() must match
+ * reference grouping (all and after mark). Last line is overhead of
+ * tracked malloc and free pair against untracked one.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#include "fmalloc.h"
+#include "mtrack.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define SLOTS 64
+#define SITES 3
+#define BENCH_BLOCKS 64
+#define BENCH_ROUNDS 100000
+
+static struct {
+	void *p;
+	int sz;
+	int site;
+	int tsk;
+	uint32_t seq;
+} slot[SLOTS];
+static int cur_tsk = 1, sch = taskSCHEDULER_RUNNING;
+static char out[4096];
+static size_t out_len;
+
+// Heap in mtrack_heap.c, calls from here go through wrappers.
+void *__real_pvPortMalloc(size_t size);
+void __real_vPortFree(void *p);
+extern int nheap;
+
+static void *site_a(size_t sz);
+static void *site_b(size_t sz);
+static void *site_c(size_t sz);
+static int test_sites(long n);
+static int cmp_sites(const char *what, boolean_t diff, uint32_t mark);
+static int test_tasks(void);
+static void bench(void);
+static int cmp_cb(const void *a, const void *b);
+static double now(void);
+
+static void *(*const site_fn[SITES])(size_t) = {site_a, site_b, site_c};
+
+int main(int argc, char **argv)
+{
+	long n = 100000;
+
+	if (argc > 1) {
+		n = strtol(argv[1], NULL, 0);
+	}
+	srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+	if (test_sites(n) || test_tasks()) {
+		return (1);
+	}
+	bench();
+	return (0);
+}
+
+/**
+ * site_a
+ */
+static __attribute__((noinline)) void *site_a(size_t sz)
+{
+	void *p = pvPortMalloc(sz);
+
+	__asm__ volatile ("");
+	return (p);
+}
+
+/**
+ * site_b
+ */
+static __attribute__((noinline)) void *site_b(size_t sz)
+{
+	void *p = pvPortMalloc(sz + 0);
+
+	__asm__ volatile ("");
+	return (p);
+}
+
+/**
+ * site_c
+ */
+static __attribute__((noinline)) void *site_c(size_t sz)
+{
+	void *p = pvPortMalloc(sz);
+
+	__asm__ volatile ("nop");
+	return (p);
+}
+
+/**
+ * test_sites
+ */
+static int test_sites(long n)
+{
+	struct mtrack_stats st;
+	uint32_t seq = 0, mark = 0;
+	int i;
+
+	for (long k = 0; k < n; k++) {
+		i = rand() % SLOTS;
+		if (k == n - n / 4) {
+			mtrack_mark();
+			mark = seq;
+		}
+		if (slot[i].p) {
+			vPortFree(slot[i].p);
+			slot[i].p = NULL;
+			continue;
+		}
+		slot[i].sz = 1 + rand() % 300;
+		slot[i].site = rand() % SITES;
+		slot[i].tsk = cur_tsk = 1 + rand() % 2;
+		slot[i].seq = seq++;
+		slot[i].p = (*site_fn[slot[i].site])(slot[i].sz);
+	}
+	mtrack_get_stats(&st);
+	if (st.lost || st.unknown) {
+		printf("mtrack: lost=%u unknown=%u\n", st.lost, st.unknown);
+		return (1);
+	}
+	if (cmp_sites("all", FALSE, 0) || cmp_sites("diff", TRUE, mark)) {
+		return (1);
+	}
+	for (i = 0; i < SLOTS; i++) {
+		vPortFree(slot[i].p);
+		slot[i].p = NULL;
+	}
+	mtrack_get_stats(&st);
+	if (st.live || nheap) {
+		printf("mtrack: live=%d heap=%d after free\n", st.live, nheap);
+		return (1);
+	}
+	printf("mtrack sites: %ld cases, avg probe %.2f\n", n, (double) st.probes / st.ops);
+	return (0);
+}
+
+/**
+ * cmp_sites
+ *
+ * Sites are compared as sorted (bytes, count) pairs.
+ */
+static int cmp_sites(const char *what, boolean_t diff, uint32_t mark)
+{
+	static struct mtrack_site site[SITES * 2 + 1];
+	int cnt[SITES][2] = {{0}}, by[SITES][2] = {{0}}, ref[SITES * 2][2], got[SITES * 2][2];
+	int nr = 0, n;
+
+	for (int i = 0; i < SLOTS; i++) {
+		if (slot[i].p && (!diff || slot[i].seq >= mark)) {
+			cnt[slot[i].site][slot[i].tsk - 1]++;
+			by[slot[i].site][slot[i].tsk - 1] += slot[i].sz;
+		}
+	}
+	for (int s = 0; s < SITES; s++) {
+		for (int t = 0; t < 2; t++) {
+			if (cnt[s][t]) {
+				ref[nr][0] = by[s][t];
+				ref[nr++][1] = cnt[s][t];
+			}
+		}
+	}
+	n = mtrack_sites(site, SITES * 2 + 1, diff);
+	for (int i = 0; i < n; i++) {
+		if (i && site[i].bytes > site[i - 1].bytes) {
+			printf("mtrack %s: not sorted\n", what);
+			return (1);
+		}
+		got[i][0] = site[i].bytes;
+		got[i][1] = site[i].count;
+	}
+	qsort(ref, nr, sizeof(ref[0]), cmp_cb);
+	qsort(got, n, sizeof(got[0]), cmp_cb);
+	if (n != nr || memcmp(ref, got, n * sizeof(ref[0]))) {
+		printf("mtrack %s: %d sites, expected %d\n", what, n, nr);
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * test_tasks
+ *
+ * Allocation before scheduler start has no task, handle of task not in
+ * system state is printed as "?".
+ */
+static int test_tasks(void)
+{
+	struct mtrack_site site[4];
+	void *p, *q, *r;
+	int n;
+
+	sch = taskSCHEDULER_NOT_STARTED;
+	p = site_a(10);
+	sch = taskSCHEDULER_RUNNING;
+	cur_tsk = 1;
+	q = site_a(20);
+	cur_tsk = 2;
+	r = site_a(30);
+	n = mtrack_sites(site, 4, FALSE);
+	if (n != 3 || site[2].tsk != NULL || site[2].bytes != 10) {
+		printf("mtrack tasks: pre-scheduler allocation not charged to none\n");
+		return (1);
+	}
+	print_mtrack(FALSE);
+	if (!strstr(out, " one ") || !strstr(out, " ? ") || !strstr(out, " - ")) {
+		printf("mtrack tasks: names not resolved\n%s", out);
+		return (1);
+	}
+	vPortFree(p);
+	vPortFree(q);
+	vPortFree(r);
+	return (0);
+}
+
+/**
+ * bench
+ */
+static void bench(void)
+{
+	static void *p[BENCH_BLOCKS];
+	double t0, t1, t2;
+
+	t0 = now();
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_BLOCKS; i++) {
+			p[i] = pvPortMalloc(200);
+		}
+		for (int i = 0; i < BENCH_BLOCKS; i++) {
+			vPortFree(p[i]);
+		}
+	}
+	t1 = now();
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_BLOCKS; i++) {
+			p[i] = __real_pvPortMalloc(200);
+		}
+		for (int i = 0; i < BENCH_BLOCKS; i++) {
+			__real_vPortFree(p[i]);
+		}
+	}
+	t2 = now();
+	printf("mtrack overhead: tracked %.1f ns, untracked %.1f ns per malloc and free\n",
+	       (t1 - t0) / BENCH_ROUNDS / BENCH_BLOCKS, (t2 - t1) / BENCH_ROUNDS / BENCH_BLOCKS);
+}
+
+/**
+ * cmp_cb
+ */
+static int cmp_cb(const void *a, const void *b)
+{
+	const int *x = a, *y = b;
+
+	return (x[0] != y[0] ? (x[0] < y[0] ? -1 : 1) : x[1] - y[1]);
+}
+
+/**
+ * now
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+void crit_err_exit(enum crit_err err)
+{
+	printf("crit_err_exit(%d)\n", err);
+	exit(1);
+}
+
+void msg(enum msg_type type, const char *fmt, ...)
+{
+	va_list argp;
+
+	va_start(argp, fmt);
+	out_len += vsnprintf(out + out_len, sizeof(out) - out_len, fmt, argp);
+	va_end(argp);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+	return ((TaskHandle_t) (uintptr_t) cur_tsk);
+}
+
+BaseType_t xTaskGetSchedulerState(void)
+{
+	return (sch);
+}
+
+void vTaskSuspendAll(void)
+{
+}
+
+BaseType_t xTaskResumeAll(void)
+{
+	return (pdFALSE);
+}
+
+UBaseType_t uxTaskGetSystemState(TaskStatus_t *st, UBaseType_t n, uint32_t *rt)
+{
+	static char nm[] = "one";
+
+	if (n < 1) {
+		return (0);
+	}
+	st[0].xHandle = (TaskHandle_t) 1;
+	st[0].pcTaskName = nm;
+	return (1);
+}
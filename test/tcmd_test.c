@@ -0,0 +1,359 @@
+/*
+ * tcmd_test.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Console command registry test: tcmd_test [cases [seed]]
+ *
+ * Random sorted tables (1 - CMDS commands) are searched by find_tcmd() and
+ * by linear strcmp() scan, results must match and probes must stay within
+ * binary search bound. init_tcmd() must refuse unsorted tables. tcmd_lp()
+ * is checked on fixed lines (arguments, quotes, help, errors). Last lines
+ * are lookup timing against linear scan and tcmd_stats() footprint.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#include "tcmd.h"
+#include <setjmp.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CMDS 128
+#define NM_LEN 12
+#define MAX_PRB 8
+#define BENCH_N 4096
+#define BENCH_ROUNDS 200
+
+static char nm[CMDS][NM_LEN];
+static struct tcmd tbl[CMDS];
+static char out[4096];
+static size_t out_len;
+static int fn_argc, fn_ret;
+static char fn_argv[TERMCMD_MAX_ARGS][32];
+static jmp_buf crit_jmp;
+static boolean_t crit_exp;
+
+static int test_find(long n);
+static int test_order(void);
+static int test_lp(void);
+static int run_lp(const char *ln, const char *exp);
+static void bench(void);
+static void gen(int cnt);
+static int linear(const char *s, int cnt);
+static int fn(int argc, char **argv);
+static int cmp_cb(const void *a, const void *b);
+static void rnd_nm(char *s);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+	long n = 10000;
+
+	if (argc > 1) {
+		n = strtol(argv[1], NULL, 0);
+	}
+	srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+	if (test_find(n) || test_order() || test_lp()) {
+		return (1);
+	}
+	bench();
+	return (0);
+}
+
+/**
+ * test_find
+ *
+ * Every name of table and random names (mostly absent) are looked up.
+ */
+static int test_find(long n)
+{
+	const struct tcmd *p;
+	char s[NM_LEN];
+	int cnt, k, mx;
+
+	for (long i = 0; i < n; i++) {
+		cnt = 1 + rand() % CMDS;
+		gen(cnt);
+		init_tcmd(tbl, cnt);
+		for (int j = 0; j < cnt + 16; j++) {
+			if (j < cnt) {
+				strcpy(s, nm[j]);
+			} else {
+				rnd_nm(s);
+			}
+			p = find_tcmd(s);
+			k = linear(s, cnt);
+			if (p != (k < 0 ? NULL : tbl + k)) {
+				printf("find_tcmd: %s in %d commands, got %d exp %d\n", s, cnt,
+				       p ? (int) (p - tbl) : -1, k);
+				return (1);
+			}
+		}
+	}
+	out_len = 0;
+	tcmd_stats();
+	if (!strstr(out, "maxprb=") || sscanf(strstr(out, "maxprb="), "maxprb=%d", &mx) != 1 ||
+	    mx > MAX_PRB) {
+		printf("find_tcmd: probes over bound: %s", out);
+		return (1);
+	}
+	printf("find_tcmd: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * test_order
+ *
+ * Swapped and duplicate names.
+ */
+static int test_order(void)
+{
+	struct tcmd t;
+	int cnt;
+
+	for (int i = 0; i < 2; i++) {
+		cnt = 2 + rand() % (CMDS - 1);
+		gen(cnt);
+		if (i) {
+			tbl[1].nm = tbl[0].nm;
+		} else {
+			t = tbl[0];
+			tbl[0] = tbl[1];
+			tbl[1] = t;
+		}
+		crit_exp = TRUE;
+		if (!setjmp(crit_jmp)) {
+			init_tcmd(tbl, cnt);
+			printf("init_tcmd: %s table not refused\n", i ? "duplicate" : "unsorted");
+			return (1);
+		}
+		crit_exp = FALSE;
+	}
+	return (0);
+}
+
+/**
+ * test_lp
+ */
+static int test_lp(void)
+{
+	static const struct tcmd t[] = {
+		{"get", fn, "key"},
+		{"set", fn, "key value"},
+		{"zap", fn, NULL}
+	};
+
+	init_tcmd(t, 3);
+	if (run_lp("  set\tkey  \"a b\"  c ", "") || fn_argc != 4 || strcmp(fn_argv[0], "set") ||
+	    strcmp(fn_argv[1], "key") || strcmp(fn_argv[2], "a b") || strcmp(fn_argv[3], "c")) {
+		printf("tcmd_lp: arguments not split\n");
+		return (1);
+	}
+	if (run_lp("get \"open", "") || fn_argc != 2 || strcmp(fn_argv[1], "open")) {
+		printf("tcmd_lp: unterminated quote\n");
+		return (1);
+	}
+	fn_argc = -1;
+	if (run_lp("", "") || run_lp(" \t ", "") || fn_argc != -1) {
+		printf("tcmd_lp: empty line ran command\n");
+		return (1);
+	}
+	if (run_lp("get 1 2 3 4 5 6 7", "") || fn_argc != TERMCMD_MAX_ARGS ||
+	    run_lp("get 1 2 3 4 5 6 7 8", "too many arguments\n") ||
+	    run_lp("nosuch", "unknown command\n") || run_lp("help set", "set key value\n") ||
+	    run_lp("help nosuch", "unknown command\n") ||
+	    run_lp("help", "get key\nset key value\nzap \n")) {
+		return (1);
+	}
+	fn_ret = 1;
+	if (run_lp("set", "set key value\n") || run_lp("zap", "zap: bad arguments\n")) {
+		return (1);
+	}
+	fn_ret = 0;
+	printf("tcmd_lp: ok\n");
+	return (0);
+}
+
+/**
+ * run_lp
+ *
+ * Returns: 0 if output of line is exp.
+ */
+static int run_lp(const char *ln, const char *exp)
+{
+	char s[128];
+
+	strcpy(s, ln);
+	out_len = 0;
+	out[0] = '\0';
+	tcmd_lp(s);
+	if (strcmp(out, exp)) {
+		printf("tcmd_lp: \"%s\" printed \"%s\", expected \"%s\"\n", ln, out, exp);
+		return (1);
+	}
+	return (0);
+}
+
+/**
+ * bench
+ *
+ * Present names of CMDS command table, linear scan is strcmp() chain of
+ * application line callback.
+ */
+static void bench(void)
+{
+	static int v[BENCH_N];
+	volatile int sink = 0;
+	double t0, t1, t2;
+
+	gen(CMDS);
+	init_tcmd(tbl, CMDS);
+	for (int i = 0; i < BENCH_N; i++) {
+		v[i] = rand() % CMDS;
+	}
+	t0 = now();
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			sink += find_tcmd(nm[v[i]]) != NULL;
+		}
+	}
+	t1 = now();
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			sink += linear(nm[v[i]], CMDS);
+		}
+	}
+	t2 = now();
+	(void) sink;
+	printf("find_tcmd: %.1f ns, linear strcmp %.1f ns (%d commands)\n",
+	       (t1 - t0) / BENCH_ROUNDS / BENCH_N, (t2 - t1) / BENCH_ROUNDS / BENCH_N, CMDS);
+	out_len = 0;
+	tcmd_stats();
+	printf("%s", out);
+}
+
+/**
+ * gen
+ *
+ * Sorted table of cnt unique random names.
+ */
+static void gen(int cnt)
+{
+	for (int i = 0; i < cnt; i++) {
+		rnd_nm(nm[i]);
+		for (int j = 0; j < i; j++) {
+			if (!strcmp(nm[i], nm[j])) {
+				i--;
+				break;
+			}
+		}
+	}
+	qsort(nm, cnt, NM_LEN, cmp_cb);
+	for (int i = 0; i < cnt; i++) {
+		tbl[i].nm = nm[i];
+		tbl[i].fn = fn;
+		tbl[i].hlp = NULL;
+	}
+}
+
+/**
+ * linear
+ *
+ * Returns: Index of s or -1.
+ */
+static int linear(const char *s, int cnt)
+{
+	for (int i = 0; i < cnt; i++) {
+		if (!strcmp(s, tbl[i].nm)) {
+			return (i);
+		}
+	}
+	return (-1);
+}
+
+/**
+ * fn
+ */
+static int fn(int argc, char **argv)
+{
+	fn_argc = argc;
+	for (int i = 0; i < argc; i++) {
+		snprintf(fn_argv[i], sizeof(fn_argv[i]), "%s", argv[i]);
+	}
+	return (fn_ret);
+}
+
+/**
+ * cmp_cb
+ */
+static int cmp_cb(const void *a, const void *b)
+{
+	return (strcmp(a, b));
+}
+
+/**
+ * rnd_nm
+ *
+ * Name of 2 - NM_LEN - 1 letters, common prefixes are likely.
+ */
+static void rnd_nm(char *s)
+{
+	int len = 2 + rand() % (NM_LEN - 2);
+
+	for (int i = 0; i < len; i++) {
+		*s++ = 'a' + rand() % (i < 2 ? 3 : 26);
+	}
+	*s = '\0';
+}
+
+/**
+ * now
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+void crit_err_exit(enum crit_err err)
+{
+	if (crit_exp) {
+		longjmp(crit_jmp, 1);
+	}
+	printf("crit_err_exit(%d)\n", err);
+	exit(1);
+}
+
+void add_msg_tout(const char *fmt, ...)
+{
+	va_list argp;
+
+	va_start(argp, fmt);
+	out_len += vsnprintf(out + out_len, sizeof(out) - out_len, fmt, argp);
+	va_end(argp);
+}
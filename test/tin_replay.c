@@ -0,0 +1,358 @@
+/*
+ * tin_replay.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Console replay: tin_replay <in> <echo> <lp>
+ *
+ * Recorded byte stream <in> is fed to tin.c through receive function, bytes
+ * sent by tout.c are written to <echo> and lines delivered to lp callback to
+ * <lp> (one per line). Last line printed is tin_stats() output, times are in
+ * ns.
+ *
+ * Tasks are cooperative coroutines, blocking call yields to scheduler. In
+ * two task mode receive function yields before every byte, so output task
+ * sends echo of previous byte first. In TERMIO mode input arrives in chunks
+ * of RX_CHUNK bytes.
+ */
+
+#include <FreeRTOS.h>
+#include <task.h>
+#include <semphr.h>
+#include <queue.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "msgconf.h"
+#if TERMIO == 1
+#include "hwerr.h"
+#endif
+#include "tin.h"
+#include <ucontext.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define RX_CHUNK 7
+#define MAX_TASKS 4
+#define STACK_SIZE 65536
+#define QUE_SIZE 64
+
+static struct tsk {
+	ucontext_t ctx;
+	void (*fn)(void *);
+	char stk[STACK_SIZE];
+} tsk[MAX_TASKS], *cur;
+static int ntsk;
+static ucontext_t main_ctx;
+
+static struct {
+	char *it[QUE_SIZE];
+	int len, head, cnt;
+} que;
+
+static unsigned char *in;
+static size_t in_len, in_pos;
+static boolean_t feed, gap;
+static unsigned int ops;
+static char ech[1 << 16], lns[1 << 16];
+static size_t ech_len, lns_len;
+
+static void sched(void);
+static void yield(void);
+static void tsk_entry(void);
+static int rfn(void *dev, void *p, TickType_t tm);
+static int sfn(void *dev, void *p, int sz);
+static void lp(char *s);
+static void *ld_file(const char *fn, size_t *sz);
+static void wr_file(const char *fn, const char *p, size_t sz);
+
+int main(int argc, char **argv)
+{
+	if (argc != 4) {
+		fprintf(stderr, "usage: tin_replay <in> <echo> <lp>\n");
+		return (2);
+	}
+	in = ld_file(argv[1], &in_len);
+	init_tout(sfn, NULL);
+	init_tin(rfn, NULL, lp);
+	// Start messages are not compared.
+	sched();
+	ech_len = 0;
+	feed = TRUE;
+	sched();
+	if (in_pos != in_len) {
+		fprintf(stderr, "%s: stopped at byte %zu\n", argv[1], in_pos);
+		return (1);
+	}
+	wr_file(argv[2], ech, ech_len);
+	wr_file(argv[3], lns, lns_len);
+	ech_len = 0;
+	tin_stats();
+	sched();
+	printf("%s: %.*s", argv[1], (int) ech_len, ech);
+	return (0);
+}
+
+/**
+ * sched
+ *
+ * Run tasks until round without input byte or queue operation.
+ */
+static void sched(void)
+{
+	unsigned int n;
+
+	do {
+		n = ops;
+		for (int i = 0; i < ntsk; i++) {
+			cur = &tsk[i];
+			swapcontext(&main_ctx, &cur->ctx);
+			cur = NULL;
+		}
+	} while (n != ops);
+}
+
+/**
+ * yield
+ */
+static void yield(void)
+{
+	swapcontext(&cur->ctx, &main_ctx);
+}
+
+/**
+ * tsk_entry
+ */
+static void tsk_entry(void)
+{
+	(*cur->fn)(NULL);
+}
+
+/**
+ * rfn
+ */
+static int rfn(void *dev, void *p, TickType_t tm)
+{
+#if TERMIO == 1
+	if (gap || !feed || in_pos == in_len) {
+		gap = FALSE;
+		return (TERMIO_RFN_EMPTY);
+	}
+#else
+	do {
+		yield();
+	} while (!feed || in_pos == in_len);
+#endif
+	*(unsigned char *) p = in[in_pos++];
+	gap = !(in_pos % RX_CHUNK);
+	ops++;
+	return (0);
+}
+
+/**
+ * sfn
+ */
+static int sfn(void *dev, void *p, int sz)
+{
+	if (ech_len + sz > sizeof(ech)) {
+		crit_err_exit(APP_ERROR);
+	}
+	memcpy(ech + ech_len, p, sz);
+	ech_len += sz;
+	return (0);
+}
+
+/**
+ * lp
+ */
+static void lp(char *s)
+{
+	size_t n = strlen(s);
+
+	if (lns_len + n + 1 > sizeof(lns)) {
+		crit_err_exit(APP_ERROR);
+	}
+	memcpy(lns + lns_len, s, n);
+	lns_len += n;
+	lns[lns_len++] = '\n';
+}
+
+/**
+ * ld_file
+ */
+static void *ld_file(const char *fn, size_t *sz)
+{
+	FILE *f;
+	void *p;
+	long n;
+
+	if (NULL == (f = fopen(fn, "rb")) || fseek(f, 0, SEEK_END) || (n = ftell(f)) < 0) {
+		perror(fn);
+		exit(2);
+	}
+	rewind(f);
+	p = malloc(n + 1);
+	if (p == NULL || (long) fread(p, 1, n, f) != n) {
+		perror(fn);
+		exit(2);
+	}
+	fclose(f);
+	*sz = n;
+	return (p);
+}
+
+/**
+ * wr_file
+ */
+static void wr_file(const char *fn, const char *p, size_t sz)
+{
+	FILE *f;
+
+	if (NULL == (f = fopen(fn, "wb")) || fwrite(p, 1, sz, f) != sz || fclose(f)) {
+		perror(fn);
+		exit(2);
+	}
+}
+
+unsigned int test_cnt(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+void crit_err_exit(enum crit_err err)
+{
+	fprintf(stderr, "crit_err_exit(%d)\n", err);
+	exit(1);
+}
+
+void msg(enum msg_type type, const char *fmt, ...)
+{
+	va_list argp;
+
+	va_start(argp, fmt);
+	v_add_msg_tout(fmt, argp);
+	va_end(argp);
+}
+
+BaseType_t xTaskCreate(void (*fn)(void *), const char *nm, uint32_t ssz, void *p,
+                       UBaseType_t prio, TaskHandle_t *hndl)
+{
+	struct tsk *t;
+
+	if (ntsk == MAX_TASKS) {
+		return (pdFAIL);
+	}
+	t = &tsk[ntsk++];
+	t->fn = fn;
+	getcontext(&t->ctx);
+	t->ctx.uc_stack.ss_sp = t->stk;
+	t->ctx.uc_stack.ss_size = sizeof(t->stk);
+	t->ctx.uc_link = NULL;
+	makecontext(&t->ctx, tsk_entry, 0);
+	*hndl = t;
+	return (pdPASS);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+	return (cur);
+}
+
+void vTaskDelay(TickType_t tm)
+{
+	yield();
+}
+
+BaseType_t xTaskNotify(TaskHandle_t hndl, uint32_t v, eNotifyAction a)
+{
+	return (pdPASS);
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t hndl, uint32_t v, eNotifyAction a,
+                              BaseType_t *p_woken)
+{
+	return (pdPASS);
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clr_in, uint32_t clr_out, uint32_t *p_v,
+                           TickType_t tm)
+{
+	yield();
+	return (pdTRUE);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t isz)
+{
+	if (len > QUE_SIZE || isz != sizeof(char *)) {
+		return (NULL);
+	}
+	que.len = len;
+	return (&que);
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *p, TickType_t tm)
+{
+	if (que.cnt == que.len) {
+		return (errQUEUE_FULL);
+	}
+	memcpy(&que.it[(que.head + que.cnt++) % que.len], p, sizeof(char *));
+	ops++;
+	return (pdPASS);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t q, void *p, TickType_t tm)
+{
+	while (!que.cnt) {
+		if (tm != portMAX_DELAY) {
+			return (pdFALSE);
+		}
+		yield();
+	}
+	memcpy(p, &que.it[que.head], sizeof(char *));
+	return (pdTRUE);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *p, TickType_t tm)
+{
+	if (pdFALSE == xQueuePeek(q, p, tm)) {
+		return (pdFALSE);
+	}
+	que.head = (que.head + 1) % que.len;
+	que.cnt--;
+	ops++;
+	return (pdTRUE);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+	return (&que);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t tm)
+{
+	return (pdTRUE);
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+	return (pdTRUE);
+}
@@ -0,0 +1,117 @@
+/*
+ * tools_ref.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Reference for tools_test.c: tools.c functions as they were before
+ * rewrite, unchanged except names. Used for comparison and benchmarks.
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "tools_ref.h"
+#include <string.h>
+
+/**
+ * ref_bit_pos
+ */
+int ref_bit_pos(unsigned int bmp)
+{
+	unsigned int cmp = 0x01;
+	int pos = 0;
+
+	for (; pos < (int) sizeof(unsigned int) * 8; pos++) {
+		if (bmp & cmp) {
+			break;
+		} else {
+			cmp <<= 1;
+		}
+	}
+	return (pos);
+}
+
+/**
+ * ref_long_division
+ */
+unsigned long long ref_long_division(unsigned long long n, unsigned long long d)
+{
+	unsigned long long q = 0, r = 0, bit;
+
+	for (int i = 63; i >= 0; i--) {
+		bit = (unsigned long long) 1 << i;
+		r = r << 1;
+		if (n & bit) {
+			r |= 0x01;
+		}
+		if (r >= d) {
+			r = r - d;
+			q |= bit;
+		}
+	}
+	return q;
+}
+
+/**
+ * ref_prn_bv_str
+ */
+void ref_prn_bv_str(char *s, unsigned int n, int sz)
+{
+	unsigned int m = 1 << (sz - 1);
+
+	for (int i = sz; i > 0; i--) {
+		if (i != sz && !(i % 4)) {
+			*s++ = ' ';
+		}
+		if (n & m) {
+			*s++ = '1';
+		} else {
+			*s++ = '0';
+		}
+		if (i == 1) {
+			*s++ = '\0';
+		}
+		n <<= 1;
+	}
+}
+
+/**
+ * ref_conv_bv_sz
+ */
+boolean_t ref_conv_bv_sz(const char *s, unsigned int *n, int sz)
+{
+	int bsz = 0;
+
+	*n = 0;
+	for (int i = 0; i < (int) strlen(s); i++) {
+		if (*(s + i) == '0' || *(s + i) == '1') {
+			*n <<= 1;
+			if (*(s + i) == '1') {
+				*n |= 1;
+			}
+			bsz++;
+		} else if (*(s + i) == ' ') {
+			continue;
+		} else {
+			return (FALSE);
+		}
+	}
+	if (bsz != sz) {
+		return (FALSE);
+	}
+	return (TRUE);
+}
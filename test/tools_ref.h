@@ -0,0 +1,50 @@
+/*
+ * tools_ref.h
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef TOOLS_REF_H
+#define TOOLS_REF_H
+
+/**
+ * ref_bit_pos
+ *
+ * Baseline bit_pos().
+ */
+int ref_bit_pos(unsigned int bmp);
+
+/**
+ * ref_long_division
+ *
+ * Baseline long_division().
+ */
+unsigned long long ref_long_division(unsigned long long n, unsigned long long d);
+
+/**
+ * ref_prn_bv_str
+ *
+ * Baseline prn_bv_str().
+ */
+void ref_prn_bv_str(char *s, unsigned int n, int sz);
+
+/**
+ * ref_conv_bv_sz
+ *
+ * Baseline conv_bv_sz().
+ */
+boolean_t ref_conv_bv_sz(const char *s, unsigned int *n, int sz);
+
+#endif
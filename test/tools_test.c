@@ -0,0 +1,695 @@
+/*
+ * tools_test.c
+ *
+ * Copyright (c) 2026 Jan Rusnak <jan@rusnak.sk>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+/*
+ * Randomized tests of tools.c and bitops.c: tools_test [cases [seed]]
+ *
+ * Results are compared with bit by bit models and with baseline functions
+ * kept in tools_ref.c. Last lines are timings against baseline.
+ */
+
+#include <FreeRTOS.h>
+#include <gentyp.h>
+#include "sysconf.h"
+#include "criterr.h"
+#include "tools.h"
+#include "bitops.h"
+#include "tools_ref.h"
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_NBITS 200
+#define TXT_N 256
+#define BV_LEN BV_STR_SIZE(64, 1)
+#define GUARD 0x5A
+#define BENCH_N 4096
+#define BENCH_ROUNDS 2000
+
+static int test_bit(long n);
+static int test_bmp(long n);
+static int test_div(long n);
+static void bench_bit_pos(void);
+static void bench_div(void);
+static int test_txt(long n);
+static void bench_txt(void);
+static int test_bv(long n);
+static void bench_bv(void);
+static void model_bv(char *s, uint64_t v, int sz, int grp);
+static uint32_t rnd32(void);
+static uint64_t rnd_w(void);
+
+TXT_TBL_DIRECT_DEF(dir_tbl, 10, [0] = "ten", [2] = "twelve", [5] = "fifteen");
+TXT_TBL_SORTED_DEF(srt_tbl, {-7, "minus seven"}, {3, "three"}, {1000, "thousand"});
+
+static char txt_s[TXT_N][8];
+static const char *txt_str[TXT_N];
+static struct txt_item txt_item[TXT_N + 1];
+static jmp_buf crit_jmp;
+static boolean_t crit_exp;
+static double now(void);
+
+int main(int argc, char **argv)
+{
+	long n = 100000;
+
+	if (argc > 1) {
+		n = strtol(argv[1], NULL, 0);
+	}
+	srand(argc > 2 ? strtoul(argv[2], NULL, 0) : 1);
+	if (test_bit(n) || test_bmp(n / 10) || test_div(n) ||
+	    test_txt(n / 100) || test_bv(n)) {
+		return (1);
+	}
+	bench_bit_pos();
+	bench_div();
+	bench_txt();
+	bench_bv();
+	return (0);
+}
+
+/**
+ * test_bit
+ *
+ * bit_ctz(), bit_clz(), bit_popcnt() and bit_pos() on values with random
+ * density (zero included).
+ */
+static int test_bit(long n)
+{
+	uint32_t v;
+	int ctz, clz, pop;
+
+	for (long i = 0; i < n; i++) {
+		v = rnd32();
+		switch (i % 4) {
+		case 0 :
+			v &= rnd32();
+			v &= rnd32();
+			break;
+		case 1 :
+			v = (uint32_t) 1 << (v % 32);
+			break;
+		case 2 :
+			v >>= v % 33 % 32;
+			break;
+		default :
+			break;
+		}
+		if (i == 0) {
+			v = 0;
+		}
+		ctz = clz = 32;
+		pop = 0;
+		for (int k = 0; k < 32; k++) {
+			if (v >> k & 1) {
+				ctz = k < ctz ? k : ctz;
+				clz = 31 - k;
+				pop++;
+			}
+		}
+		if (bit_ctz(v) != ctz || bit_clz(v) != clz || bit_popcnt(v) != pop ||
+		    bit_pos(v) != ctz || ref_bit_pos(v) != ctz) {
+			printf("bit: v=%08X ctz=%d clz=%d pop=%d pos=%d\n", (unsigned int) v, bit_ctz(v),
+			       bit_clz(v), bit_popcnt(v), bit_pos(v));
+			return (1);
+		}
+	}
+	printf("bit: %ld cases, builtin %d\n", n, BITOPS_BUILTIN);
+	return (0);
+}
+
+/**
+ * test_bmp
+ *
+ * Multi-word bitmaps of random size and density against bit array model,
+ * then bmp_alloc() until full and bmp_free() of random bits.
+ */
+static int test_bmp(long n)
+{
+	uint32_t bmp[BMP_WORDS(MAX_NBITS)];
+	uint8_t b[MAX_NBITS];
+	int nb, pop, ffz, k, j;
+
+	for (long i = 0; i < n; i++) {
+		nb = 1 + rand() % MAX_NBITS;
+		k = rand() % 4;
+		memset(bmp, 0, sizeof(bmp));
+		pop = 0;
+		ffz = -1;
+		for (j = 0; j < nb; j++) {
+			b[j] = k == 0 ? rand() % 64 == 0 : (k == 1 ? rand() % 64 != 0 : rand() & 1);
+			if (b[j]) {
+				bmp_set(bmp, j);
+				pop++;
+			} else if (ffz < 0) {
+				ffz = j;
+			}
+		}
+		for (j = 0; j < nb; j++) {
+			if (bmp_tst(bmp, j) != b[j]) {
+				printf("bmp_tst: nbits=%d bit=%d\n", nb, j);
+				return (1);
+			}
+		}
+		if (bmp_popcnt(bmp, nb) != pop || bmp_ffz(bmp, nb) != ffz) {
+			printf("bmp: nbits=%d popcnt=%d/%d ffz=%d/%d\n", nb, bmp_popcnt(bmp, nb), pop,
+			       bmp_ffz(bmp, nb), ffz);
+			return (1);
+		}
+		for (int from = 0; from <= nb; from++) {
+			for (j = from; j < nb && !b[j]; j++) {
+			}
+			if (bmp_fns(bmp, nb, from) != (j < nb ? j : -1)) {
+				printf("bmp_fns: nbits=%d from=%d got=%d\n", nb, from,
+				       bmp_fns(bmp, nb, from));
+				return (1);
+			}
+		}
+		j = 0;
+		BMP_FOR_EACH(k, bmp, nb) {
+			while (j < nb && !b[j]) {
+				j++;
+			}
+			if (k != j++) {
+				printf("BMP_FOR_EACH: nbits=%d bit=%d\n", nb, k);
+				return (1);
+			}
+		}
+		while (j < nb && !b[j]) {
+			j++;
+		}
+		if (j != nb) {
+			printf("BMP_FOR_EACH: nbits=%d missed bit=%d\n", nb, j);
+			return (1);
+		}
+		for (j = 0; j < nb - pop; j++) {
+			for (k = 0; b[k]; k++) {
+			}
+			if (bmp_alloc(bmp, nb) != k) {
+				printf("bmp_alloc: nbits=%d expected=%d\n", nb, k);
+				return (1);
+			}
+			b[k] = 1;
+		}
+		if (bmp_alloc(bmp, nb) != -1 || bmp_ffz(bmp, nb) != -1) {
+			printf("bmp_alloc: nbits=%d full bitmap\n", nb);
+			return (1);
+		}
+		k = rand() % nb;
+		bmp_free(bmp, k);
+		if (bmp_tst(bmp, k) || bmp_popcnt(bmp, nb) != nb - 1 || bmp_alloc(bmp, nb) != k) {
+			printf("bmp_free: nbits=%d bit=%d\n", nb, k);
+			return (1);
+		}
+		bmp_clr(bmp, k);
+		if (bmp_ffz(bmp, nb) != k) {
+			printf("bmp_clr: nbits=%d bit=%d\n", nb, k);
+			return (1);
+		}
+	}
+	printf("bmp: %ld cases, cas %d\n", n, BITOPS_CAS);
+	return (0);
+}
+
+/**
+ * test_div
+ *
+ * udiv64(), udiv64_rcp() and muldiv64() against __int128 arithmetic,
+ * operands of random width, long_division() against baseline.
+ */
+static int test_div(long n)
+{
+	struct udiv64_rcp rc;
+	unsigned __int128 p;
+	uint64_t a, b, d, q, r, eq, er;
+	boolean_t ok;
+
+	for (long i = 0; i < n; i++) {
+		a = rnd_w();
+		d = rnd_w();
+		if (i % 64 == 0) {
+			d = 0;
+		}
+		q = udiv64(a, d, &r);
+		eq = d ? a / d : ~(uint64_t) 0;
+		er = d ? a % d : a;
+		if (q != eq || r != er || (d && long_division(a, d) != eq)) {
+			printf("udiv64: n=%016llX d=%016llX q=%016llX r=%016llX\n",
+			       (unsigned long long) a, (unsigned long long) d, (unsigned long long) q,
+			       (unsigned long long) r);
+			return (1);
+		}
+		if (d && ref_long_division(a, d) != eq) {
+			printf("baseline long_division: n=%016llX d=%016llX\n", (unsigned long long) a,
+			       (unsigned long long) d);
+			return (1);
+		}
+		if (d) {
+			init_udiv64_rcp(&rc, d);
+			for (int k = 0; k < 4; k++) {
+				a = k ? rnd_w() : ~(uint64_t) 0 - rand() % 2;
+				q = udiv64_rcp(&rc, a, &r);
+				if (q != a / d || r != a % d) {
+					printf("udiv64_rcp: n=%016llX d=%016llX q=%016llX\n",
+					       (unsigned long long) a, (unsigned long long) d,
+					       (unsigned long long) q);
+					return (1);
+				}
+			}
+		}
+		a = rnd_w();
+		b = rnd_w();
+		p = (unsigned __int128) a * b;
+		q = r = 0x5A5A5A5A5A5A5A5AULL;
+		ok = muldiv64(a, b, d, &q, &r);
+		if (d == 0 || p / d > ~(uint64_t) 0) {
+			if (ok || q != 0x5A5A5A5A5A5A5A5AULL || r != 0x5A5A5A5A5A5A5A5AULL) {
+				printf("muldiv64: a=%016llX b=%016llX c=%016llX not refused\n",
+				       (unsigned long long) a, (unsigned long long) b, (unsigned long long) d);
+				return (1);
+			}
+		} else if (!ok || q != (uint64_t) (p / d) || r != (uint64_t) (p % d)) {
+			printf("muldiv64: a=%016llX b=%016llX c=%016llX\n", (unsigned long long) a,
+			       (unsigned long long) b, (unsigned long long) d);
+			return (1);
+		}
+	}
+	printf("div: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * test_txt
+ *
+ * Declared tables, then random direct (with holes) and sorted tables
+ * against find_txt_item() over same items. check_txt_tbl() must refuse
+ * unsorted and duplicate idx.
+ */
+static int test_txt(long n)
+{
+	struct txt_tbl tbl;
+	const char *a, *b;
+	int cnt, base, v, k;
+
+	if (strcmp(find_txt(&dir_tbl, 12, "?"), "twelve") || strcmp(find_txt(&dir_tbl, 11, "?"), "?") ||
+	    strcmp(find_txt(&dir_tbl, 16, "?"), "?") || strcmp(find_txt(&dir_tbl, 9, "?"), "?") ||
+	    strcmp(find_txt(&srt_tbl, -7, "?"), "minus seven") ||
+	    strcmp(find_txt(&srt_tbl, 1000, "?"), "thousand") || strcmp(find_txt(&srt_tbl, 4, "?"), "?")) {
+		printf("find_txt: declared tables\n");
+		return (1);
+	}
+	CHECK_TXT_TBL(&srt_tbl);
+	for (long i = 0; i < n; i++) {
+		cnt = 1 + rand() % TXT_N;
+		base = rand() % 2001 - 1000;
+		tbl.base = base;
+		tbl.n = cnt;
+		tbl.str = txt_str;
+		tbl.item = txt_item;
+		if (i & 1) {
+			tbl.type = TXT_TBL_DIRECT;
+			k = 0;
+			for (int j = 0; j < cnt; j++) {
+				txt_str[j] = NULL;
+				if (rand() % 4) {
+					snprintf(txt_s[j], sizeof(txt_s[j]), "%d", base + j);
+					txt_str[j] = txt_s[j];
+					txt_item[k].idx = base + j;
+					txt_item[k++].str = txt_s[j];
+				}
+			}
+		} else {
+			tbl.type = TXT_TBL_SORTED;
+			v = base;
+			for (k = 0; k < cnt; k++) {
+				v += 1 + rand() % (rand() % 2 ? 3 : 1000);
+				snprintf(txt_s[k], sizeof(txt_s[k]), "%d", v);
+				txt_item[k].idx = v;
+				txt_item[k].str = txt_s[k];
+			}
+			CHECK_TXT_TBL(&tbl);
+		}
+		txt_item[k].str = NULL;
+		for (int j = 0; j < 64; j++) {
+			v = j < 4 ? (j < 2 ? INT32_MIN + j : INT32_MAX - j + 2) :
+			            (k && j % 2 ? txt_item[rand() % k].idx : base - 10 + rand() % (cnt * 1001));
+			a = find_txt(&tbl, v, NULL);
+			b = find_txt_item(v, txt_item, NULL);
+			if (a != b) {
+				printf("find_txt: type=%d n=%d val=%d got=%s exp=%s\n", tbl.type, cnt, v,
+				       a ? a : "-", b ? b : "-");
+				return (1);
+			}
+		}
+		if (tbl.type == TXT_TBL_SORTED && cnt > 1) {
+			k = 1 + rand() % (cnt - 1);
+			if (rand() & 1) {
+				txt_item[k].idx = txt_item[k - 1].idx;
+			} else {
+				v = txt_item[k].idx;
+				txt_item[k].idx = txt_item[k - 1].idx;
+				txt_item[k - 1].idx = v;
+			}
+			crit_exp = TRUE;
+			if (!setjmp(crit_jmp)) {
+				CHECK_TXT_TBL(&tbl);
+				printf("check_txt_tbl: unsorted table not refused\n");
+				return (1);
+			}
+			crit_exp = FALSE;
+		}
+	}
+	printf("txt: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * test_bv
+ *
+ * prn_bv64() with random size and grouping against bitwise model (exact
+ * BV_STR_SIZE() fill), read back by conv_bv64(). Wrong size and invalid
+ * characters must be refused without writing value. Up to 32 bits
+ * prn_bv_str() and conv_bv_sz() must match baseline.
+ */
+static int test_bv(long n)
+{
+	static const char bad[] = "2a\t-/";
+	char s[BV_LEN + 1], m[BV_LEN + 2], rs[BV_LEN];
+	uint64_t v, w;
+	unsigned int u, ru;
+	int sz, grp, len, k;
+	boolean_t ok, rok;
+
+	for (long i = 0; i < n; i++) {
+		sz = 1 + rand() % 64;
+		grp = rand() % (sz + 2);
+		v = (uint64_t) rnd32() << 32 | rnd32();
+		memset(s, GUARD, sizeof(s));
+		len = prn_bv64(s, v, sz, grp);
+		model_bv(m, v, sz, grp);
+		if (strcmp(s, m) || len != (int) strlen(m) || len + 1 != BV_STR_SIZE(sz, grp) ||
+		    s[len + 1] != GUARD) {
+			printf("prn_bv64: sz=%d grp=%d got=%s exp=%s\n", sz, grp, s, m);
+			return (1);
+		}
+		v &= sz == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << sz) - 1;
+		w = ~v;
+		if (!conv_bv64(s, &w, sz) || w != v) {
+			printf("conv_bv64: %s sz=%d\n", s, sz);
+			return (1);
+		}
+		w = ~v;
+		if (conv_bv64(s, &w, sz + 1) || conv_bv64(s, &w, sz - 1) || w != ~v) {
+			printf("conv_bv64: %s accepted with wrong size\n", s);
+			return (1);
+		}
+		if (rand() & 1) {
+			m[0] = ' ';
+			memcpy(m + 1, s, len + 1);
+		} else {
+			m[rand() % len] = bad[rand() % (sizeof(bad) - 1)];
+		}
+		ok = conv_bv64(m, &w, sz);
+		if (ok != (m[0] == ' ') || w != (ok ? v : ~v)) {
+			printf("conv_bv64: %s sz=%d returned %d\n", m, sz, ok);
+			return (1);
+		}
+		if (sz > 32) {
+			continue;
+		}
+		prn_bv_str(s, v, sz);
+		ref_prn_bv_str(rs, v, sz);
+		if (strcmp(s, rs)) {
+			printf("prn_bv_str: sz=%d got=%s exp=%s\n", sz, s, rs);
+			return (1);
+		}
+		for (k = 0; k < 2; k++) {
+			ok = conv_bv_sz(k ? m : s, &u, sz);
+			rok = ref_conv_bv_sz(k ? m : s, &ru, sz);
+			if (ok != rok || (ok && u != ru)) {
+				printf("conv_bv_sz: %s sz=%d got=%d exp=%d\n", k ? m : s, sz, ok, rok);
+				return (1);
+			}
+		}
+	}
+	printf("bv: %ld cases\n", n);
+	return (0);
+}
+
+/**
+ * model_bv
+ *
+ * Space before bit i when higher bit follows and i + 1 is multiple of grp.
+ */
+static void model_bv(char *s, uint64_t v, int sz, int grp)
+{
+	for (int i = sz - 1; i >= 0; i--) {
+		if (grp > 0 && i < sz - 1 && !((i + 1) % grp)) {
+			*s++ = ' ';
+		}
+		*s++ = '0' + ((v >> i) & 1);
+	}
+	*s = '\0';
+}
+
+/**
+ * bench_bit_pos
+ *
+ * Lowest set bit uniformly distributed in 0 - 31.
+ */
+static void bench_bit_pos(void)
+{
+	static uint32_t v[BENCH_N];
+	volatile int sink;
+	double t0, t1, t2;
+	int s;
+
+	for (int i = 0; i < BENCH_N; i++) {
+		v[i] = (rnd32() | 1) << (rand() % 32);
+	}
+	s = 0;
+	t0 = now();
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			s += bit_pos(v[i]);
+		}
+	}
+	t1 = now();
+	for (int r = 0; r < BENCH_ROUNDS; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			s += ref_bit_pos(v[i]);
+		}
+	}
+	t2 = now();
+	sink = s;
+	(void) sink;
+	printf("bit_pos: %.2f ns, baseline %.2f ns\n", (t1 - t0) / BENCH_ROUNDS / BENCH_N,
+	       (t2 - t1) / BENCH_ROUNDS / BENCH_N);
+}
+
+/**
+ * bench_div
+ *
+ * Operands of random width, division by same divisor for udiv64_rcp().
+ */
+static void bench_div(void)
+{
+	static uint64_t n[BENCH_N], d[BENCH_N];
+	struct udiv64_rcp rc;
+	volatile uint64_t sink;
+	double t[4];
+	uint64_t s = 0;
+
+	for (int i = 0; i < BENCH_N; i++) {
+		n[i] = rnd_w();
+		while (!(d[i] = rnd_w())) {
+		}
+	}
+	init_udiv64_rcp(&rc, d[0]);
+	t[0] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			s += udiv64(n[i], d[i], NULL);
+		}
+	}
+	t[1] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			s += ref_long_division(n[i], d[i]);
+		}
+	}
+	t[2] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			s += udiv64_rcp(&rc, n[i], NULL);
+		}
+	}
+	t[3] = now();
+	sink = s;
+	(void) sink;
+	printf("udiv64: %.2f ns, baseline %.2f ns, udiv64_rcp %.2f ns\n",
+	       (t[1] - t[0]) / (BENCH_ROUNDS / 10) / BENCH_N,
+	       (t[2] - t[1]) / (BENCH_ROUNDS / 10) / BENCH_N,
+	       (t[3] - t[2]) / (BENCH_ROUNDS / 10) / BENCH_N);
+}
+
+/**
+ * bench_txt
+ *
+ * Sorted table of TXT_N items, random present values.
+ */
+static void bench_txt(void)
+{
+	static int v[BENCH_N];
+	struct txt_tbl tbl = {TXT_TBL_SORTED, 0, TXT_N, NULL, txt_item};
+	volatile const char *sink;
+	double t0, t1, t2;
+
+	for (int i = 0; i < TXT_N; i++) {
+		txt_item[i].idx = 3 * i;
+		txt_item[i].str = "x";
+	}
+	txt_item[TXT_N].str = NULL;
+	for (int i = 0; i < BENCH_N; i++) {
+		v[i] = 3 * (rand() % TXT_N);
+	}
+	t0 = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			sink = find_txt(&tbl, v[i], NULL);
+		}
+	}
+	t1 = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			sink = find_txt_item(v[i], txt_item, NULL);
+		}
+	}
+	t2 = now();
+	(void) sink;
+	printf("find_txt: %.2f ns, find_txt_item %.2f ns (%d items)\n",
+	       (t1 - t0) / (BENCH_ROUNDS / 10) / BENCH_N, (t2 - t1) / (BENCH_ROUNDS / 10) / BENCH_N,
+	       TXT_N);
+}
+
+/**
+ * bench_bv
+ *
+ * 32 bit prn_bv_str() and conv_bv_sz() against baseline, 64 bit
+ * prn_bv64() grouped by bytes.
+ */
+static void bench_bv(void)
+{
+	static uint32_t v[BENCH_N];
+	static char str[BENCH_N][BV_STR_SIZE(32, 4)];
+	char s[BV_LEN];
+	unsigned int u;
+	volatile unsigned int sink = 0;
+	double t[6];
+
+	for (int i = 0; i < BENCH_N; i++) {
+		v[i] = rnd32();
+		prn_bv_str(str[i], v[i], 32);
+	}
+	t[0] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			prn_bv_str(s, v[i], 32);
+			sink += s[i & 31];
+		}
+	}
+	t[1] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			ref_prn_bv_str(s, v[i], 32);
+			sink += s[i & 31];
+		}
+	}
+	t[2] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			conv_bv_sz(str[i], &u, 32);
+			sink += u;
+		}
+	}
+	t[3] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			ref_conv_bv_sz(str[i], &u, 32);
+			sink += u;
+		}
+	}
+	t[4] = now();
+	for (int r = 0; r < BENCH_ROUNDS / 10; r++) {
+		for (int i = 0; i < BENCH_N; i++) {
+			prn_bv64(s, (uint64_t) v[i] << 32 | v[i ^ 1], 64, 8);
+			sink += s[i & 63];
+		}
+	}
+	t[5] = now();
+	(void) sink;
+	for (int i = 0; i < 5; i++) {
+		t[i] = (t[i + 1] - t[i]) / (BENCH_ROUNDS / 10) / BENCH_N;
+	}
+	printf("prn_bv_str: %.2f ns, baseline %.2f ns, conv_bv_sz %.2f ns, baseline %.2f ns\n",
+	       t[0], t[1], t[2], t[3]);
+	printf("prn_bv64: %.2f ns (64 bits, grp 8)\n", t[4]);
+}
+
+/**
+ * rnd32
+ */
+static uint32_t rnd32(void)
+{
+	return (((uint32_t) rand() & 0xFFFF) << 16 | ((uint32_t) rand() & 0xFFFF));
+}
+
+/**
+ * rnd_w
+ *
+ * Returns: Random value of random width (0 - 64 bits).
+ */
+static uint64_t rnd_w(void)
+{
+	uint64_t v = (uint64_t) rnd32() << 32 | rnd32();
+	int w = rand() % 65;
+
+	return (w == 64 ? v : v & (((uint64_t) 1 << w) - 1));
+}
+
+/**
+ * now
+ */
+static double now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1e9 + ts.tv_nsec);
+}
+
+void crit_err_exit(enum crit_err err)
+{
+	if (crit_exp) {
+		longjmp(crit_jmp, 1);
+	}
+	printf("crit_err_exit(%d)\n", err);
+	exit(1);
+}